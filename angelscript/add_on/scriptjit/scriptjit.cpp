@@ -0,0 +1,942 @@
+#include <stddef.h> // offsetof
+#include <string.h>
+#include <assert.h>
+#include <vector>
+
+#include "scriptjit.h"
+
+#if defined(__x86_64__) || defined(_M_X64)
+	#define AS_JIT_X64
+	#if defined(_WIN32)
+		#define WIN32_LEAN_AND_MEAN
+		#include <windows.h>
+	#else
+		#include <sys/mman.h>
+	#endif
+#endif
+
+BEGIN_AS_NAMESPACE
+
+CScriptJIT::CScriptJIT()
+{
+	enabled                 = true;
+	compiledFunctions       = 0;
+	compiledInstructions    = 0;
+	interpretedInstructions = 0;
+}
+
+CScriptJIT::~CScriptJIT()
+{
+}
+
+void CScriptJIT::SetEnabled(bool in_enabled)
+{
+	enabled = in_enabled;
+}
+
+bool CScriptJIT::IsEnabled() const
+{
+	return enabled;
+}
+
+asUINT CScriptJIT::GetCompiledFunctionCount() const
+{
+	return compiledFunctions;
+}
+
+asUINT CScriptJIT::GetCompiledInstructionCount() const
+{
+	return compiledInstructions;
+}
+
+asUINT CScriptJIT::GetInterpretedInstructionCount() const
+{
+	return interpretedInstructions;
+}
+
+#ifndef AS_JIT_X64
+
+int CScriptJIT::CompileFunction(asIScriptFunction *, asJITFunction *)
+{
+	return asNOT_SUPPORTED;
+}
+
+void CScriptJIT::ReleaseJITFunction(asJITFunction)
+{
+}
+
+#else
+
+namespace
+{
+
+// General purpose and SSE register numbers
+enum
+{
+	RAX = 0, RCX = 1, RDX = 2, RBX = 3, R12 = 12,
+	XMM0 = 0, XMM1 = 1
+};
+
+// Condition codes for Jcc and SETcc
+enum
+{
+	CC_B = 0x2, CC_E = 0x4, CC_NE = 0x5, CC_A = 0x7, CC_P = 0xa,
+	CC_L = 0xc, CC_GE = 0xd, CC_LE = 0xe, CC_G = 0xf
+};
+
+// The generated code keeps the asSVMRegisters pointer in rbx and the stack
+// frame pointer in r12, both of which are callee saved in either ABI. rax,
+// rcx, rdx, xmm0 and xmm1 are used as scratch registers.
+const int REGS = RBX;
+const int FP   = R12;
+
+const int PROGRAM_POINTER = offsetof(asSVMRegisters, programPointer);
+const int FRAME_POINTER   = offsetof(asSVMRegisters, stackFramePointer);
+const int VALUE_REGISTER  = offsetof(asSVMRegisters, valueRegister);
+const int PROCESS_SUSPEND = offsetof(asSVMRegisters, doProcessSuspend);
+
+// Bytes in front of the code that record the size of the allocation
+const size_t CODE_HEADER = 16;
+
+const size_t NONE = size_t(-1);
+
+class CAssembler
+{
+public:
+	std::vector<asBYTE> code;
+
+	void Byte(asBYTE value)
+	{
+		code.push_back(value);
+	}
+
+	void Dword(asDWORD value)
+	{
+		for( int n = 0; n < 4; n++ )
+			Byte(asBYTE(value >> (n * 8)));
+	}
+
+	void Qword(asQWORD value)
+	{
+		for( int n = 0; n < 8; n++ )
+			Byte(asBYTE(value >> (n * 8)));
+	}
+
+	// Opcodes are either a single byte or 0x0fxx for the two byte forms
+	void Opcode(int prefix, bool w, int op, int reg, int rm)
+	{
+		if( prefix )
+			Byte(asBYTE(prefix));
+		asBYTE rex = asBYTE(0x40 | (w ? 8 : 0) | ((reg & 8) ? 4 : 0) | ((rm & 8) ? 1 : 0));
+		if( rex != 0x40 )
+			Byte(rex);
+		if( op > 0xff )
+			Byte(asBYTE(op >> 8));
+		Byte(asBYTE(op));
+	}
+
+	// op reg, rm (register direct)
+	void Reg(int prefix, bool w, int op, int reg, int rm)
+	{
+		Opcode(prefix, w, op, reg, rm);
+		Byte(asBYTE(0xc0 | ((reg & 7) << 3) | (rm & 7)));
+	}
+
+	// op reg, [base + disp]
+	void Mem(int prefix, bool w, int op, int reg, int base, int disp)
+	{
+		Opcode(prefix, w, op, reg, base);
+		Byte(asBYTE(0x80 | ((reg & 7) << 3) | (base & 7)));
+		if( (base & 7) == 4 )
+			Byte(0x24);
+		Dword(asDWORD(disp));
+	}
+
+	void Load(bool w, int reg, int base, int disp)  { Mem(0, w, 0x8b, reg, base, disp); }
+	void Store(bool w, int base, int disp, int reg) { Mem(0, w, 0x89, reg, base, disp); }
+
+	void StoreImm(bool w, int base, int disp, asDWORD value)
+	{
+		Mem(0, w, 0xc7, 0, base, disp);
+		Dword(value);
+	}
+
+	void LoadImm32(int reg, asDWORD value)
+	{
+		Opcode(0, false, 0xb8 | (reg & 7), 0, reg);
+		Dword(value);
+	}
+
+	void LoadImm64(int reg, asQWORD value)
+	{
+		Opcode(0, true, 0xb8 | (reg & 7), 0, reg);
+		Qword(value);
+	}
+
+	// Conversions into an SSE register only write its low part; clearing it
+	// first avoids a dependency on whatever instruction wrote it last
+	void ClearXmm(int xmm)
+	{
+		Reg(0, false, 0x0f57, xmm, xmm);             // xorps xmm, xmm
+	}
+
+	void SetCC(int cc, int reg)
+	{
+		Reg(0, false, 0x0f90 | cc, 0, reg);
+	}
+
+	void ZeroExtend8(int reg)
+	{
+		Reg(0, false, 0x0fb6, reg, reg);
+	}
+
+	// Returns the position just after the rel32 operand, for Patch()
+	size_t Jcc(int cc)
+	{
+		Byte(0x0f);
+		Byte(asBYTE(0x80 | cc));
+		Dword(0);
+		return code.size();
+	}
+
+	size_t Jmp()
+	{
+		Byte(0xe9);
+		Dword(0);
+		return code.size();
+	}
+
+	void Patch(size_t at, size_t target)
+	{
+		asDWORD rel = asDWORD(int(target) - int(at));
+		memcpy(&code[at - 4], &rel, 4);
+	}
+};
+
+struct SBranch
+{
+	size_t at;     // end of the rel32 operand
+	asUINT target; // bytecode offset
+	bool   exit;   // return to the interpreter even if the target was compiled
+};
+
+class CCompiler : public CAssembler
+{
+public:
+	CCompiler(asDWORD *in_byteCode, asUINT in_length)
+	{
+		byteCode     = in_byteCode;
+		length       = in_length;
+		compiled     = 0;
+		interpreted  = 0;
+		native.resize(length + 1, NONE);
+	}
+
+	asDWORD              *byteCode;
+	asUINT                length;
+	asUINT                compiled;
+	asUINT                interpreted;
+	std::vector<size_t>   native;    // code offset of each compiled instruction
+	std::vector<SBranch>  branches;
+	std::vector<size_t>   epilogueJumps;
+	std::vector<asUINT>   entries;   // JitEntry instructions that resume in native code
+
+	bool Compile();
+
+protected:
+	bool Instruction(asUINT pos, asDWORD *bc);
+
+	void Branch(size_t at, asUINT target) { SBranch b = {at, target, false}; branches.push_back(b); }
+	void ExitIf(int cc, asUINT pos)       { SBranch b = {Jcc(cc), pos, true}; branches.push_back(b); }
+	void Exit(asUINT pos);
+
+	void CompareResult(int greater, int less);
+	void FloatCompareResult(bool dbl);
+};
+
+// Returns to the interpreter, which continues at the given bytecode offset
+void CCompiler::Exit(asUINT pos)
+{
+	LoadImm64(RAX, asQWORD(asPWORD(byteCode + pos)));
+	epilogueJumps.push_back(Jmp());
+}
+
+// Stores -1, 0 or 1 in the low dword of the value register from the flags of an integer compare
+void CCompiler::CompareResult(int greater, int less)
+{
+	SetCC(greater, RAX);
+	SetCC(less, RCX);
+	ZeroExtend8(RAX);
+	ZeroExtend8(RCX);
+	Reg(0, false, 0x2b, RAX, RCX);                 // sub eax, ecx
+	Store(false, REGS, VALUE_REGISTER, RAX);
+}
+
+// Same for xmm0 compared to xmm1. Unordered values give 1, as in the interpreter
+void CCompiler::FloatCompareResult(bool dbl)
+{
+	int prefix = dbl ? 0x66 : 0;
+	Reg(prefix, false, 0x0f2e, XMM0, XMM1);        // ucomis xmm0, xmm1
+	SetCC(CC_NE, RAX);
+	SetCC(CC_P, RCX);
+	Reg(0, false, 0x08, RCX, RAX);                 // or al, cl: not equal or unordered
+	Reg(prefix, false, 0x0f2e, XMM1, XMM0);        // ucomis xmm1, xmm0
+	SetCC(CC_A, RCX);                              // less and ordered
+	ZeroExtend8(RAX);
+	ZeroExtend8(RCX);
+	Reg(0, false, 0x03, RCX, RCX);                 // add ecx, ecx
+	Reg(0, false, 0x2b, RAX, RCX);                 // sub eax, ecx
+	Store(false, REGS, VALUE_REGISTER, RAX);
+}
+
+bool CCompiler::Compile()
+{
+	// Prologue: jitArg is the address of the code to resume at
+	Byte(0x53);                                    // push rbx
+	Byte(0x41); Byte(0x54);                        // push r12
+#if defined(_WIN32)
+	Reg(0, true, 0x89, RCX, RBX);                  // mov rbx, rcx
+	Load(true, FP, REGS, FRAME_POINTER);
+	Byte(0xff); Byte(0xe2);                        // jmp rdx
+#else
+	Reg(0, true, 0x89, 7, RBX);                    // mov rbx, rdi
+	Load(true, FP, REGS, FRAME_POINTER);
+	Byte(0xff); Byte(0xe6);                        // jmp rsi
+#endif
+
+	bool reachable = false;
+	asUINT pos = 0;
+	while( pos < length )
+	{
+		asDWORD   *bc   = byteCode + pos;
+		asEBCInstr op   = asEBCInstr(*(asBYTE*)bc);
+		asUINT     size = asBCTypeSize[asBCInfo[op].type];
+		size_t     start = code.size();
+
+		if( op == asBC_JitEntry )
+		{
+			native[pos] = start;
+			reachable = true;
+		}
+		else if( Instruction(pos, bc) )
+		{
+			native[pos] = start;
+			reachable = op != asBC_JMP;
+			compiled++;
+		}
+		else
+		{
+			if( reachable )
+				Exit(pos);
+			reachable = false;
+			interpreted++;
+		}
+
+		pos += size;
+	}
+	if( reachable )
+		Exit(length);
+
+	// Only resume at entries that are followed by a compiled instruction
+	for( pos = 0; pos < length; pos += asBCTypeSize[asBCInfo[*(asBYTE*)(byteCode + pos)].type] )
+	{
+		if( *(asBYTE*)(byteCode + pos) != asBC_JitEntry )
+			continue;
+		asUINT next = pos + asBCTypeSize[asBCInfo[asBC_JitEntry].type];
+		if( next < length && native[next] != NONE && *(asBYTE*)(byteCode + next) != asBC_JitEntry )
+			entries.push_back(pos);
+	}
+	if( compiled == 0 || entries.empty() )
+		return false;
+
+	// Branches to instructions that weren't compiled return to the interpreter
+	std::vector<size_t> exits(length + 1, NONE);
+	for( asUINT n = 0; n < branches.size(); n++ )
+	{
+		const SBranch &b = branches[n];
+		if( !b.exit && native[b.target] != NONE )
+		{
+			Patch(b.at, native[b.target]);
+			continue;
+		}
+		if( exits[b.target] == NONE )
+		{
+			exits[b.target] = code.size();
+			Exit(b.target);
+		}
+		Patch(b.at, exits[b.target]);
+	}
+
+	// Epilogue: rax holds the bytecode position to continue at
+	size_t epilogue = code.size();
+	Store(true, REGS, PROGRAM_POINTER, RAX);
+	Byte(0x41); Byte(0x5c);                        // pop r12
+	Byte(0x5b);                                    // pop rbx
+	Byte(0xc3);                                    // ret
+	for( asUINT n = 0; n < epilogueJumps.size(); n++ )
+		Patch(epilogueJumps[n], epilogue);
+
+	return true;
+}
+
+// Emits the native code for one instruction, or returns false without emitting
+// anything if the instruction must be executed by the interpreter
+bool CCompiler::Instruction(asUINT pos, asDWORD *bc)
+{
+	// Variable offsets relative to the stack frame pointer
+	int a = -4 * int(asBC_SWORDARG0(bc));
+	int b = -4 * int(asBC_SWORDARG1(bc));
+	int c = -4 * int(asBC_SWORDARG2(bc));
+	int vr = VALUE_REGISTER;
+
+	asEBCInstr op = asEBCInstr(*(asBYTE*)bc);
+	switch( op )
+	{
+	// Branches
+	case asBC_JMP:
+		Branch(Jmp(), pos + 2 + asBC_INTARG(bc));
+		return true;
+
+	case asBC_JZ:
+	case asBC_JNZ:
+	case asBC_JS:
+	case asBC_JNS:
+	case asBC_JP:
+	case asBC_JNP:
+	{
+		static const int cc[] = {CC_E, CC_NE, CC_L, CC_GE, CC_G, CC_LE};
+		Mem(0, false, 0x83, 7, REGS, vr); Byte(0);     // cmp dword [vr], 0
+		Branch(Jcc(cc[op - asBC_JZ]), pos + 2 + asBC_INTARG(bc));
+		return true;
+	}
+
+	case asBC_JLowZ:
+	case asBC_JLowNZ:
+		Mem(0, false, 0x80, 7, REGS, vr); Byte(0);     // cmp byte [vr], 0
+		Branch(Jcc(op == asBC_JLowZ ? CC_E : CC_NE), pos + 2 + asBC_INTARG(bc));
+		return true;
+
+	case asBC_SUSPEND:
+		Mem(0, false, 0x80, 7, REGS, PROCESS_SUSPEND); Byte(0);
+		ExitIf(CC_NE, pos);
+		return true;
+
+	// Tests
+	case asBC_TZ:
+	case asBC_TNZ:
+	case asBC_TS:
+	case asBC_TNS:
+	case asBC_TP:
+	case asBC_TNP:
+	{
+		static const int cc[] = {CC_E, CC_NE, CC_L, CC_GE, CC_G, CC_LE};
+		Mem(0, false, 0x83, 7, REGS, vr); Byte(0);
+		SetCC(cc[op - asBC_TZ], RAX);
+		ZeroExtend8(RAX);
+		Store(true, REGS, vr, RAX);
+		return true;
+	}
+
+	case asBC_NOT:
+		Mem(0, false, 0x80, 7, FP, a); Byte(0);        // cmp byte [a], 0
+		SetCC(CC_E, RAX);
+		ZeroExtend8(RAX);
+		Store(false, FP, a, RAX);
+		return true;
+
+	case asBC_ClrHi:
+		Mem(0, false, 0x81, 4, REGS, vr); Dword(0xff); // and dword [vr], 0xff
+		return true;
+
+	// Comparisons
+	case asBC_CMPi:
+	case asBC_CMPu:
+	case asBC_CMPi64:
+	case asBC_CMPu64:
+	{
+		bool w = op == asBC_CMPi64 || op == asBC_CMPu64;
+		bool sign = op == asBC_CMPi || op == asBC_CMPi64;
+		Load(w, RAX, FP, a);
+		Mem(0, w, 0x3b, RAX, FP, b);                   // cmp eax, [b]
+		CompareResult(sign ? CC_G : CC_A, sign ? CC_L : CC_B);
+		return true;
+	}
+
+	case asBC_CMPIi:
+	case asBC_CMPIu:
+		Load(false, RAX, FP, a);
+		Reg(0, false, 0x81, 7, RAX); Dword(asBC_DWORDARG(bc));
+		CompareResult(op == asBC_CMPIi ? CC_G : CC_A, op == asBC_CMPIi ? CC_L : CC_B);
+		return true;
+
+	case asBC_CMPf:
+		Mem(0xf3, false, 0x0f10, XMM0, FP, a);
+		Mem(0xf3, false, 0x0f10, XMM1, FP, b);
+		FloatCompareResult(false);
+		return true;
+
+	case asBC_CMPIf:
+		Mem(0xf3, false, 0x0f10, XMM0, FP, a);
+		LoadImm32(RCX, asBC_DWORDARG(bc));
+		Reg(0x66, false, 0x0f6e, XMM1, RCX);           // movd xmm1, ecx
+		FloatCompareResult(false);
+		return true;
+
+	case asBC_CMPd:
+		Mem(0xf2, false, 0x0f10, XMM0, FP, a);
+		Mem(0xf2, false, 0x0f10, XMM1, FP, b);
+		FloatCompareResult(true);
+		return true;
+
+	// Unary operations on variables
+	case asBC_NEGi:   Mem(0, false, 0xf7, 3, FP, a); return true;
+	case asBC_NEGi64: Mem(0, true,  0xf7, 3, FP, a); return true;
+	case asBC_BNOT:   Mem(0, false, 0xf7, 2, FP, a); return true;
+	case asBC_BNOT64: Mem(0, true,  0xf7, 2, FP, a); return true;
+	case asBC_IncVi:  Mem(0, false, 0xff, 0, FP, a); return true;
+	case asBC_DecVi:  Mem(0, false, 0xff, 1, FP, a); return true;
+	case asBC_NEGf:   Mem(0, false, 0x81, 6, FP, a); Dword(0x80000000); return true;
+	case asBC_NEGd:   Mem(0, true, 0x0fba, 7, FP, a); Byte(63); return true;
+
+	// Increments of the value the register points to
+	case asBC_INCi8:
+	case asBC_DECi8:
+		Load(true, RAX, REGS, vr);
+		Mem(0, false, 0xfe, op == asBC_INCi8 ? 0 : 1, RAX, 0);
+		return true;
+
+	case asBC_INCi16:
+	case asBC_DECi16:
+		Load(true, RAX, REGS, vr);
+		Mem(0x66, false, 0xff, op == asBC_INCi16 ? 0 : 1, RAX, 0);
+		return true;
+
+	case asBC_INCi:
+	case asBC_DECi:
+	case asBC_INCi64:
+	case asBC_DECi64:
+		Load(true, RAX, REGS, vr);
+		Mem(0, op == asBC_INCi64 || op == asBC_DECi64, 0xff, op == asBC_INCi || op == asBC_INCi64 ? 0 : 1, RAX, 0);
+		return true;
+
+	case asBC_INCf:
+	case asBC_DECf:
+		Load(true, RAX, REGS, vr);
+		Mem(0xf3, false, 0x0f10, XMM0, RAX, 0);
+		LoadImm32(RCX, 0x3f800000);                    // 1.0f
+		Reg(0x66, false, 0x0f6e, XMM1, RCX);
+		Reg(0xf3, false, op == asBC_INCf ? 0x0f58 : 0x0f5c, XMM0, XMM1);
+		Mem(0xf3, false, 0x0f11, XMM0, RAX, 0);
+		return true;
+
+	case asBC_INCd:
+	case asBC_DECd:
+		Load(true, RAX, REGS, vr);
+		Mem(0xf2, false, 0x0f10, XMM0, RAX, 0);
+		LoadImm64(RCX, 0x3ff0000000000000ull);         // 1.0
+		Reg(0x66, true, 0x0f6e, XMM1, RCX);
+		Reg(0xf2, false, op == asBC_INCd ? 0x0f58 : 0x0f5c, XMM0, XMM1);
+		Mem(0xf2, false, 0x0f11, XMM0, RAX, 0);
+		return true;
+
+	// Integer arithmetic
+	case asBC_ADDi:   case asBC_SUBi:   case asBC_MULi:
+	case asBC_BAND:   case asBC_BOR:    case asBC_BXOR:
+	case asBC_ADDi64: case asBC_SUBi64: case asBC_MULi64:
+	case asBC_BAND64: case asBC_BOR64:  case asBC_BXOR64:
+	{
+		bool w = op >= asBC_NEGi64;
+		int alu;
+		switch( op )
+		{
+		case asBC_ADDi: case asBC_ADDi64: alu = 0x03;   break;
+		case asBC_SUBi: case asBC_SUBi64: alu = 0x2b;   break;
+		case asBC_MULi: case asBC_MULi64: alu = 0x0faf; break;
+		case asBC_BAND: case asBC_BAND64: alu = 0x23;   break;
+		case asBC_BOR:  case asBC_BOR64:  alu = 0x0b;   break;
+		default:                          alu = 0x33;   break;
+		}
+		Load(w, RAX, FP, b);
+		Mem(0, w, alu, RAX, FP, c);
+		Store(w, FP, a, RAX);
+		return true;
+	}
+
+	case asBC_BSLL:   case asBC_BSRL:   case asBC_BSRA:
+	case asBC_BSLL64: case asBC_BSRL64: case asBC_BSRA64:
+	{
+		bool w = op >= asBC_BSLL64;
+		int ext = (op == asBC_BSLL || op == asBC_BSLL64) ? 4 : (op == asBC_BSRL || op == asBC_BSRL64) ? 5 : 7;
+		Load(w, RAX, FP, b);
+		Load(false, RCX, FP, c);
+		Reg(0, w, 0xd3, ext, RAX);                     // shift eax, cl
+		Store(w, FP, a, RAX);
+		return true;
+	}
+
+	case asBC_ADDIi:
+	case asBC_SUBIi:
+		Load(false, RAX, FP, b);
+		Reg(0, false, 0x81, op == asBC_ADDIi ? 0 : 5, RAX); Dword(asBC_DWORDARG(bc + 1));
+		Store(false, FP, a, RAX);
+		return true;
+
+	case asBC_MULIi:
+		Load(false, RAX, FP, b);
+		Reg(0, false, 0x69, RAX, RAX); Dword(asBC_DWORDARG(bc + 1));
+		Store(false, FP, a, RAX);
+		return true;
+
+	// Division by zero and overflow are left to the interpreter to raise the exception
+	case asBC_DIVi:  case asBC_MODi:
+	case asBC_DIVi64: case asBC_MODi64:
+	{
+		bool w = op == asBC_DIVi64 || op == asBC_MODi64;
+		Load(w, RCX, FP, c);
+		Reg(0, w, 0x85, RCX, RCX);                     // test ecx, ecx
+		ExitIf(CC_E, pos);
+		Reg(0, w, 0x83, 7, RCX); Byte(0xff);           // cmp ecx, -1
+		ExitIf(CC_E, pos);
+		Load(w, RAX, FP, b);
+		Opcode(0, w, 0x99, 0, 0);                      // cdq
+		Reg(0, w, 0xf7, 7, RCX);                       // idiv ecx
+		Store(w, FP, a, (op == asBC_DIVi || op == asBC_DIVi64) ? RAX : RDX);
+		return true;
+	}
+
+	case asBC_DIVu:  case asBC_MODu:
+	case asBC_DIVu64: case asBC_MODu64:
+	{
+		bool w = op == asBC_DIVu64 || op == asBC_MODu64;
+		Load(w, RCX, FP, c);
+		Reg(0, w, 0x85, RCX, RCX);
+		ExitIf(CC_E, pos);
+		Load(w, RAX, FP, b);
+		Reg(0, false, 0x33, RDX, RDX);                 // xor edx, edx
+		Reg(0, w, 0xf7, 6, RCX);                       // div ecx
+		Store(w, FP, a, (op == asBC_DIVu || op == asBC_DIVu64) ? RAX : RDX);
+		return true;
+	}
+
+	// Floating point arithmetic
+	case asBC_ADDf: case asBC_SUBf: case asBC_MULf: case asBC_DIVf:
+	case asBC_ADDd: case asBC_SUBd: case asBC_MULd: case asBC_DIVd:
+	{
+		bool dbl = op >= asBC_ADDd;
+		int prefix = dbl ? 0xf2 : 0xf3;
+		int alu;
+		switch( op )
+		{
+		case asBC_ADDf: case asBC_ADDd: alu = 0x0f58; break;
+		case asBC_SUBf: case asBC_SUBd: alu = 0x0f5c; break;
+		case asBC_MULf: case asBC_MULd: alu = 0x0f59; break;
+		default:                        alu = 0x0f5e; break;
+		}
+		if( op == asBC_DIVf || op == asBC_DIVd )
+		{
+			// Zero (and NaN) dividers go to the interpreter
+			Reg(dbl ? 0x66 : 0, false, 0x0f57, XMM1, XMM1);      // xorp xmm1, xmm1
+			Mem(dbl ? 0x66 : 0, false, 0x0f2e, XMM1, FP, c);     // ucomis xmm1, [c]
+			ExitIf(CC_E, pos);
+		}
+		Mem(prefix, false, 0x0f10, XMM0, FP, b);
+		Mem(prefix, false, alu, XMM0, FP, c);
+		Mem(prefix, false, 0x0f11, XMM0, FP, a);
+		return true;
+	}
+
+	case asBC_ADDIf:
+	case asBC_SUBIf:
+	case asBC_MULIf:
+		Mem(0xf3, false, 0x0f10, XMM0, FP, b);
+		LoadImm32(RCX, asBC_DWORDARG(bc + 1));
+		Reg(0x66, false, 0x0f6e, XMM1, RCX);
+		Reg(0xf3, false, op == asBC_ADDIf ? 0x0f58 : op == asBC_SUBIf ? 0x0f5c : 0x0f59, XMM0, XMM1);
+		Mem(0xf3, false, 0x0f11, XMM0, FP, a);
+		return true;
+
+	// Conversions
+	case asBC_iTOf:
+		ClearXmm(XMM0);
+		Mem(0xf3, false, 0x0f2a, XMM0, FP, a);         // cvtsi2ss xmm0, dword [a]
+		Mem(0xf3, false, 0x0f11, XMM0, FP, a);
+		return true;
+
+	case asBC_uTOf:
+		Load(false, RAX, FP, a);
+		ClearXmm(XMM0);
+		Reg(0xf3, true, 0x0f2a, XMM0, RAX);            // cvtsi2ss xmm0, rax
+		Mem(0xf3, false, 0x0f11, XMM0, FP, a);
+		return true;
+
+	case asBC_fTOi:
+	case asBC_fTOu:
+		Mem(0xf3, false, 0x0f2c, RAX, FP, a);          // cvttss2si eax, [a]
+		Store(false, FP, a, RAX);
+		return true;
+
+	case asBC_sbTOi: Mem(0, false, 0x0fbe, RAX, FP, a); Store(false, FP, a, RAX); return true;
+	case asBC_swTOi: Mem(0, false, 0x0fbf, RAX, FP, a); Store(false, FP, a, RAX); return true;
+	case asBC_ubTOi: Mem(0, false, 0x0fb6, RAX, FP, a); Store(false, FP, a, RAX); return true;
+	case asBC_uwTOi: Mem(0, false, 0x0fb7, RAX, FP, a); Store(false, FP, a, RAX); return true;
+	case asBC_iTOb:  Mem(0, false, 0x0fb6, RAX, FP, a); Store(false, FP, a, RAX); return true;
+	case asBC_iTOw:  Mem(0, false, 0x0fb7, RAX, FP, a); Store(false, FP, a, RAX); return true;
+
+	case asBC_dTOi:
+	case asBC_dTOu:
+		Mem(0xf2, false, 0x0f2c, RAX, FP, b);          // cvttsd2si eax, [b]
+		Store(false, FP, a, RAX);
+		return true;
+
+	case asBC_dTOf:
+		ClearXmm(XMM0);
+		Mem(0xf2, false, 0x0f5a, XMM0, FP, b);         // cvtsd2ss xmm0, [b]
+		Mem(0xf3, false, 0x0f11, XMM0, FP, a);
+		return true;
+
+	case asBC_iTOd:
+		ClearXmm(XMM0);
+		Mem(0xf2, false, 0x0f2a, XMM0, FP, b);         // cvtsi2sd xmm0, dword [b]
+		Mem(0xf2, false, 0x0f11, XMM0, FP, a);
+		return true;
+
+	case asBC_uTOd:
+		Load(false, RAX, FP, b);
+		ClearXmm(XMM0);
+		Reg(0xf2, true, 0x0f2a, XMM0, RAX);            // cvtsi2sd xmm0, rax
+		Mem(0xf2, false, 0x0f11, XMM0, FP, a);
+		return true;
+
+	case asBC_fTOd:
+		ClearXmm(XMM0);
+		Mem(0xf3, false, 0x0f5a, XMM0, FP, b);         // cvtss2sd xmm0, [b]
+		Mem(0xf2, false, 0x0f11, XMM0, FP, a);
+		return true;
+
+	case asBC_i64TOi:
+		Load(false, RAX, FP, b);
+		Store(false, FP, a, RAX);
+		return true;
+
+	case asBC_uTOi64:
+		Load(false, RAX, FP, b);
+		Store(true, FP, a, RAX);
+		return true;
+
+	case asBC_iTOi64:
+		Mem(0, true, 0x63, RAX, FP, b);                // movsxd rax, [b]
+		Store(true, FP, a, RAX);
+		return true;
+
+	case asBC_fTOi64:
+	case asBC_fTOu64:
+		Mem(0xf3, true, 0x0f2c, RAX, FP, b);           // cvttss2si rax, [b]
+		Store(true, FP, a, RAX);
+		return true;
+
+	case asBC_dTOi64:
+	case asBC_dTOu64:
+		Mem(0xf2, true, 0x0f2c, RAX, FP, a);           // cvttsd2si rax, [a]
+		Store(true, FP, a, RAX);
+		return true;
+
+	case asBC_i64TOf:
+		ClearXmm(XMM0);
+		Mem(0xf3, true, 0x0f2a, XMM0, FP, b);          // cvtsi2ss xmm0, qword [b]
+		Mem(0xf3, false, 0x0f11, XMM0, FP, a);
+		return true;
+
+	case asBC_i64TOd:
+		ClearXmm(XMM0);
+		Mem(0xf2, true, 0x0f2a, XMM0, FP, a);          // cvtsi2sd xmm0, qword [a]
+		Mem(0xf2, false, 0x0f11, XMM0, FP, a);
+		return true;
+
+	// Variables, globals and the value register
+	case asBC_SetV1:
+	case asBC_SetV2:
+	case asBC_SetV4:
+		StoreImm(false, FP, a, asBC_DWORDARG(bc));
+		return true;
+
+	case asBC_SetV8:
+		LoadImm64(RAX, asBC_QWORDARG(bc));
+		Store(true, FP, a, RAX);
+		return true;
+
+	case asBC_CpyVtoV4:
+	case asBC_CpyVtoV8:
+		Load(op == asBC_CpyVtoV8, RAX, FP, b);
+		Store(op == asBC_CpyVtoV8, FP, a, RAX);
+		return true;
+
+	case asBC_CpyVtoR4:
+	case asBC_CpyVtoR8:
+		Load(op == asBC_CpyVtoR8, RAX, FP, a);
+		Store(op == asBC_CpyVtoR8, REGS, vr, RAX);
+		return true;
+
+	case asBC_CpyRtoV4:
+	case asBC_CpyRtoV8:
+		Load(op == asBC_CpyRtoV8, RAX, REGS, vr);
+		Store(op == asBC_CpyRtoV8, FP, a, RAX);
+		return true;
+
+	case asBC_CpyVtoG4:
+		LoadImm64(RCX, asBC_PTRARG(bc));
+		Load(false, RAX, FP, a);
+		Store(false, RCX, 0, RAX);
+		return true;
+
+	case asBC_CpyGtoV4:
+		LoadImm64(RCX, asBC_PTRARG(bc));
+		Load(false, RAX, RCX, 0);
+		Store(false, FP, a, RAX);
+		return true;
+
+	case asBC_SetG4:
+		LoadImm64(RCX, asBC_PTRARG(bc));
+		StoreImm(false, RCX, 0, asBC_DWORDARG(bc + AS_PTR_SIZE));
+		return true;
+
+	case asBC_LdGRdR4:
+		LoadImm64(RCX, asBC_PTRARG(bc));
+		Store(true, REGS, vr, RCX);
+		Load(false, RAX, RCX, 0);
+		Store(false, FP, a, RAX);
+		return true;
+
+	case asBC_LDG:
+		LoadImm64(RAX, asBC_PTRARG(bc));
+		Store(true, REGS, vr, RAX);
+		return true;
+
+	case asBC_LDV:
+		Mem(0, true, 0x8d, RAX, FP, a);                // lea rax, [a]
+		Store(true, REGS, vr, RAX);
+		return true;
+
+	case asBC_WRTV1:
+		Load(true, RCX, REGS, vr);
+		Mem(0, false, 0x0fb6, RAX, FP, a);
+		Mem(0, false, 0x88, RAX, RCX, 0);              // mov [rcx], al
+		return true;
+
+	case asBC_WRTV2:
+		Load(true, RCX, REGS, vr);
+		Mem(0, false, 0x0fb7, RAX, FP, a);
+		Mem(0x66, false, 0x89, RAX, RCX, 0);           // mov [rcx], ax
+		return true;
+
+	case asBC_WRTV4:
+	case asBC_WRTV8:
+		Load(true, RCX, REGS, vr);
+		Load(op == asBC_WRTV8, RAX, FP, a);
+		Store(op == asBC_WRTV8, RCX, 0, RAX);
+		return true;
+
+	case asBC_RDR1:
+	case asBC_RDR2:
+		Load(true, RCX, REGS, vr);
+		Mem(0, false, op == asBC_RDR1 ? 0x0fb6 : 0x0fb7, RAX, RCX, 0);
+		Store(false, FP, a, RAX);
+		return true;
+
+	case asBC_RDR4:
+	case asBC_RDR8:
+		Load(true, RCX, REGS, vr);
+		Load(op == asBC_RDR8, RAX, RCX, 0);
+		Store(op == asBC_RDR8, FP, a, RAX);
+		return true;
+
+	default:
+		// Everything else, including calls, returns and all use of the script
+		// stack, is left to the interpreter
+		return false;
+	}
+}
+
+} // namespace
+
+int CScriptJIT::CompileFunction(asIScriptFunction *function, asJITFunction *output)
+{
+	if( !enabled )
+		return asNOT_SUPPORTED;
+
+	asUINT length = 0;
+	asDWORD *byteCode = function->GetByteCode(&length);
+	if( byteCode == 0 || length == 0 )
+		return asNOT_SUPPORTED;
+
+	CCompiler compiler(byteCode, length);
+	bool compiled = compiler.Compile();
+	interpretedInstructions += compiler.interpreted;
+
+	// Clear the entries left behind by an earlier compilation of the function
+	for( asUINT pos = 0; pos < length; pos += asBCTypeSize[asBCInfo[*(asBYTE*)(byteCode + pos)].type] )
+	{
+		if( *(asBYTE*)(byteCode + pos) == asBC_JitEntry )
+			asBC_PTRARG(byteCode + pos) = 0;
+	}
+
+	if( !compiled )
+	{
+		interpretedInstructions += compiler.compiled;
+		return asNOT_SUPPORTED;
+	}
+
+	size_t size = CODE_HEADER + compiler.code.size();
+#if defined(_WIN32)
+	asBYTE *memory = (asBYTE*)VirtualAlloc(0, size, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE);
+	if( memory == 0 )
+		return asOUT_OF_MEMORY;
+#else
+	asBYTE *memory = (asBYTE*)mmap(0, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if( memory == MAP_FAILED )
+		return asOUT_OF_MEMORY;
+#endif
+
+	memcpy(memory, &size, sizeof(size));
+	memcpy(memory + CODE_HEADER, &compiler.code[0], compiler.code.size());
+
+#if defined(_WIN32)
+	DWORD previous;
+	VirtualProtect(memory, size, PAGE_EXECUTE_READ, &previous);
+	FlushInstructionCache(GetCurrentProcess(), memory, size);
+#else
+	mprotect(memory, size, PROT_READ | PROT_EXEC);
+#endif
+
+	// The interpreter passes the JitEntry argument on to the native code, which jumps to it
+	asBYTE *code = memory + CODE_HEADER;
+	for( asUINT n = 0; n < compiler.entries.size(); n++ )
+	{
+		asUINT pos = compiler.entries[n];
+		asBC_PTRARG(byteCode + pos) = asPWORD(code + compiler.native[pos]);
+	}
+
+	compiledFunctions++;
+	compiledInstructions += compiler.compiled;
+
+	*output = asJITFunction(asPWORD(code));
+	return asSUCCESS;
+}
+
+void CScriptJIT::ReleaseJITFunction(asJITFunction func)
+{
+	if( func == 0 )
+		return;
+
+	asBYTE *memory = (asBYTE*)asPWORD(func) - CODE_HEADER;
+#if defined(_WIN32)
+	VirtualFree(memory, 0, MEM_RELEASE);
+#else
+	size_t size;
+	memcpy(&size, memory, sizeof(size));
+	munmap(memory, size);
+#endif
+}
+
+#endif
+
+END_AS_NAMESPACE
@@ -0,0 +1,52 @@
+#ifndef SCRIPTJIT_H
+#define SCRIPTJIT_H
+
+#ifndef ANGELSCRIPT_H
+// Avoid having to inform include path if header is already include before
+#include <angelscript.h>
+#endif
+
+BEGIN_AS_NAMESPACE
+
+// A template JIT compiler that translates script bytecode to x86-64 machine
+// code (System V and Windows calling conventions).
+//
+// Only instructions that work on local variables, global variables, the value
+// register and branches within the function are translated. Any other
+// instruction (calls, object handling, the script stack) returns control to
+// the interpreter, which re-enters the native code at the next JitEntry. The
+// results are identical to the interpreter, including script exceptions, as
+// every check that could fail is left to the interpreter.
+//
+// The engine property asEP_INCLUDE_JIT_INSTRUCTIONS must be enabled before
+// scripts are built or loaded. On other architectures no function is compiled.
+class CScriptJIT : public asIJITCompiler
+{
+public:
+	CScriptJIT();
+	virtual ~CScriptJIT();
+
+	// While disabled, functions that are built or loaded are left to the interpreter
+	void SetEnabled(bool enabled);
+	bool IsEnabled() const;
+
+	// Number of functions and bytecode instructions compiled to native code, and
+	// number of instructions left to the interpreter, since creation
+	asUINT GetCompiledFunctionCount() const;
+	asUINT GetCompiledInstructionCount() const;
+	asUINT GetInterpretedInstructionCount() const;
+
+	// asIJITCompiler
+	int  CompileFunction(asIScriptFunction *function, asJITFunction *output);
+	void ReleaseJITFunction(asJITFunction func);
+
+protected:
+	bool   enabled;
+	asUINT compiledFunctions;
+	asUINT compiledInstructions;
+	asUINT interpretedInstructions;
+};
+
+END_AS_NAMESPACE
+
+#endif
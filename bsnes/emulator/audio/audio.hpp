@@ -66,6 +66,7 @@ struct Stream {
   auto pending() const -> uint;
   auto read(double samples[]) -> uint;
   auto write(const double samples[]) -> void;
+  auto samples(const int16* samples, uint count, double scale = 1.0 / 32768.0) -> void;
 
   template<typename... P> auto sample(P&&... p) -> void {
     double samples[sizeof...(P)] = {forward<P>(p)...};
@@ -87,7 +88,7 @@ private:
   friend class Audio;
 };
 
-extern Audio audio;
+extern instance_local Audio audio;
 
 }
 
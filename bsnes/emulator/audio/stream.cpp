@@ -116,6 +116,56 @@ auto Stream::write(const double samples[]) -> void {
   audio.process();
 }
 
+//[jsd] writes count frames of interleaved samples, each multiplied by scale. every filter and the resampler run over a
+//whole block at once, and stereo streams are processed one frame per SIMD operation
+auto Stream::samples(const int16* samples, uint count, double scale) -> void {
+  if(!channels) return;
+  enum : uint { BlockSize = 512 };
+  double block[BlockSize];
+  uint channelCount = channels.size();
+  bool stereo = channelCount == 2 && channels[0].nyquist.size() == channels[1].nyquist.size();
+
+  while(count) {
+    uint frames = min(count, BlockSize / channelCount);
+    for(uint n : range(frames * channelCount)) {
+      block[n] = samples[n] * scale + 1e-25;  //constant offset used to suppress denormals
+    }
+
+    for(auto c : range(channelCount)) {
+      for(auto& filter : channels[c].filters) {
+        switch(filter.mode) {
+        case Filter::Mode::DCRemoval:
+          for(uint n : range(frames)) block[n * channelCount + c] = filter.dcRemoval.process(block[n * channelCount + c]);
+          break;
+        case Filter::Mode::OnePole:
+          for(uint n : range(frames)) block[n * channelCount + c] = filter.onePole.process(block[n * channelCount + c]);
+          break;
+        case Filter::Mode::Biquad:
+          filter.biquad.process(block + c, frames, channelCount);
+          break;
+        }
+      }
+    }
+
+    if(stereo) {
+      for(uint pass : range(channels[0].nyquist.size())) {
+        DSP::IIR::Biquad::process(channels[0].nyquist[pass], channels[1].nyquist[pass], block, frames);
+      }
+      DSP::Resampler::Cubic::write(channels[0].resampler, channels[1].resampler, block, frames);
+    } else {
+      for(auto c : range(channelCount)) {
+        for(auto& filter : channels[c].nyquist) filter.process(block + c, frames, channelCount);
+        channels[c].resampler.write(block + c, frames, channelCount);
+      }
+    }
+
+    //the resampler queues only hold 20ms, so mix each block before writing the next one:
+    audio.process();
+    samples += frames * channelCount;
+    count -= frames;
+  }
+}
+
 auto Stream::serialize(serializer& s) -> void {
   for(auto& channel : channels) {
     channel.resampler.serialize(s);
@@ -15,8 +15,6 @@ struct Cheat {
     uint address;
     uint data;
     maybe<uint> compare;
-    bool enable;
-    uint restore;
   };
 
   explicit operator bool() const {
@@ -25,10 +23,14 @@ struct Cheat {
 
   auto reset() -> void {
     codes.reset();
+    memory::fill<uint64_t>(filter, Filter / 64);
   }
 
+  //codes are kept sorted by address, in the order they were given for each address:
   auto append(uint address, uint data, maybe<uint> compare = {}) -> void {
     codes.append({address, data, compare});
+    for(uint n = codes.size() - 1; n && codes[n - 1].address > address; n--) swap(codes[n - 1], codes[n]);
+    filter[hash(address) >> 6] |= 1ull << (hash(address) & 63);
   }
 
   auto assign(const vector<string>& list) -> void {
@@ -42,16 +44,37 @@ struct Cheat {
     }
   }
 
-  auto find(uint address, uint compare) -> maybe<uint> {
-    for(auto& code : codes) {
-      if(code.address == address && (!code.compare || code.compare() == compare)) {
-        return code.data;
-      }
+  //called on every memory read, so addresses without a code are rejected by the filter first:
+  alwaysinline auto find(uint address, uint compare) const -> maybe<uint> {
+    if(!(filter[hash(address) >> 6] >> (hash(address) & 63) & 1)) return nothing;
+    return search(address, compare);
+  }
+
+  vector<Code> codes;
+
+private:
+  enum : uint { Filter = 65536 };
+
+  static auto hash(uint address) -> uint {
+    return (address ^ address >> 16) & Filter - 1;
+  }
+
+  auto search(uint address, uint compare) const -> maybe<uint> {
+    uint lo = 0, hi = codes.size();
+    while(lo < hi) {
+      uint mid = lo + hi >> 1;
+      if(codes[mid].address < address) lo = mid + 1;
+      else hi = mid;
+    }
+    for(; lo < codes.size() && codes[lo].address == address; lo++) {
+      auto& code = codes[lo];
+      if(!code.compare || code.compare() == compare) return code.data;
     }
     return nothing;
   }
 
-  vector<Code> codes;
+  //one bit per hash of the addresses that have a code:
+  uint64_t filter[Filter / 64] = {};
 };
 
 }
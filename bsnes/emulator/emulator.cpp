@@ -3,6 +3,6 @@
 
 namespace Emulator {
 
-Platform* platform = nullptr;
+instance_local Platform* platform = nullptr;
 
 }
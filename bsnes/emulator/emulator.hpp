@@ -24,6 +24,14 @@
 #include <nall/thread-pool.hpp>
 using namespace nall;
 
+//[jsd] built with EMULATOR_INSTANCES (make instances=true), every thread runs its own console: state outside of the
+//console's components is thread-local, and the components are bound to threads by SuperFamicom::Instance.
+#if defined(EMULATOR_INSTANCES)
+  #define instance_local thread_local
+#else
+  #define instance_local
+#endif
+
 #include <emulator/types.hpp>
 #include <emulator/memory/readable.hpp>
 #include <emulator/memory/writable.hpp>
@@ -32,6 +40,7 @@ using namespace nall;
 // [jsd] add support for AngelScript
 #include <angelscript.h>
 #include <scriptarray.h>
+#include <scriptjit.h>
 
 #include "version.generated.hpp"
 
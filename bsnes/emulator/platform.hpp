@@ -30,6 +30,6 @@ struct Platform {
   virtual auto scriptMessage(const string& msg, bool alert = false) -> void { printf("script: %.*s\n", msg.size(), msg.data()); };
 };
 
-extern Platform* platform;
+extern instance_local Platform* platform;
 
 }
@@ -123,4 +123,4 @@ private:
   friend class ICD;
 };
 
-extern Cartridge cartridge;
+SFC_EXTERN(Cartridge, cartridge);
@@ -124,6 +124,9 @@ auto Cartridge::loadMemory(Memory& ram, Markup::Node node, bool required) -> voi
     if(auto fp = platform->open(pathID(), memory->name(), File::Read, required)) {
       fp->read(ram.data(), min(fp->size(), ram.size()));
     }
+#if defined(EMULATOR_INSTANCES)
+    if(memory->type == "ROM") ram.share();
+#endif
   }
 }
 
@@ -2,7 +2,7 @@
 
 namespace SuperFamicom {
 
-Cx4 cx4;
+SFC_GLOBAL(Cx4, cx4);
 #define CX4_CPP
 #include "data.cpp"
 #include "functions.cpp"
@@ -6,7 +6,7 @@
 namespace SuperFamicom {
 
 #include "serialization.cpp"
-DIP dip;
+SFC_GLOBAL(DIP, dip);
 
 auto DIP::power() -> void {
 }
@@ -11,4 +11,4 @@ struct DIP {
   uint8 value = 0x00;
 };
 
-extern DIP dip;
+SFC_EXTERN(DIP, dip);
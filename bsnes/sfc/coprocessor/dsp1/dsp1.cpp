@@ -13,7 +13,7 @@ namespace SuperFamicom {
 #define DSP1_CPP
 #include "dsp1emu.hpp"
 #include "dsp1emu.cpp"
-Dsp1 dsp1emu;
+instance_local Dsp1 dsp1emu;
 #undef   int8
 #undef  int16
 #undef  int32
@@ -23,7 +23,7 @@ Dsp1 dsp1emu;
 #undef uint32
 #undef uint64
 
-DSP1 dsp1;
+SFC_GLOBAL(DSP1, dsp1);
 #include "serialization.cpp"
 
 auto DSP1::power() -> void {
@@ -35,4 +35,4 @@ struct DSP2 {
   void op0d();
 };
 
-extern DSP2 dsp2;
+SFC_EXTERN(DSP2, dsp2);
@@ -3,7 +3,7 @@
 namespace SuperFamicom {
 
 #include "serialization.cpp"
-Event event;
+SFC_GLOBAL(Event, event);
 
 auto Event::synchronizeCPU() -> void {
   if(clock >= 0) scheduler.resume(cpu.thread);
@@ -48,4 +48,4 @@ private:
   uint scoreSecondsRemaining;
 };
 
-extern Event event;
+SFC_EXTERN(Event, event);
@@ -2,7 +2,7 @@
 
 namespace SuperFamicom {
 
-ICD icd;
+SFC_GLOBAL(ICD, icd);
 #include "interface.cpp"
 #include "io.cpp"
 #include "boot-roms.cpp"
@@ -37,9 +37,7 @@ namespace SameBoy {
   }
 
   static auto sample(GB_gameboy_t*, GB_sample_t* sample) -> void {
-    float left  = sample->left  / 32768.0f;
-    float right = sample->right / 32768.0f;
-    icd.apuWrite(left, right);
+    icd.apuWrite(sample->left, sample->right);
   }
 
   static auto vblank(GB_gameboy_t*) -> void {
@@ -62,7 +60,7 @@ auto ICD::main() -> void {
     auto clocks = GB_run(&sameboy);
     step(clocks >> 1);
   } else {  //DMG halted
-    apuWrite(0.0, 0.0);
+    apuWrite(0, 0);
     step(128);
   }
   synchronizeCPU();
@@ -145,6 +143,7 @@ auto ICD::power(bool reset) -> void {
   auto frequency = clockFrequency() / 5;
   create(ICD::Enter, frequency);
   if(!reset) stream = Emulator::audio.createStream(2, frequency / 128);
+  batchCount = 0;
 
   for(auto& packet : this->packet) packet = {};
   packetSize = 0;
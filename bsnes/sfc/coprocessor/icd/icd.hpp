@@ -19,7 +19,8 @@ struct ICD : Emulator::Platform, Thread {
   auto ppuHreset() -> void;
   auto ppuVreset() -> void;
   auto ppuWrite(uint2 color) -> void;
-  auto apuWrite(float left, float right) -> void;
+  auto apuWrite(int16 left, int16 right) -> void;
+  auto apuFlush() -> void;
   auto joypWrite(bool p14, bool p15) -> void;
 
   //io.cpp
@@ -70,6 +71,11 @@ private:
   uint8 hcounter;
   uint8 vcounter;
 
+  //[jsd] audible samples are handed to the stream in batches, so it filters and resamples them as a block:
+  enum : uint { BatchSize = 128 };
+  int16 batch[BatchSize * 2];
+  uint batchCount = 0;
+
   struct Information {
     uint pathID = 0;
   } information;
@@ -82,4 +88,4 @@ public:
   uint32_t bitmap[160 * 144];
 };
 
-extern ICD icd;
+SFC_EXTERN(ICD, icd);
@@ -19,9 +19,16 @@ auto ICD::ppuWrite(uint2 color) -> void {
   output[address + 1] = (output[address + 1] << 1) | !!(color & 2);
 }
 
-auto ICD::apuWrite(float left, float right) -> void {
-  double samples[] = {left, right};
-  if(!system.runAhead) stream->write(samples);
+auto ICD::apuWrite(int16 left, int16 right) -> void {
+  if(system.runAhead) return;
+  batch[batchCount * 2 + 0] = left;
+  batch[batchCount * 2 + 1] = right;
+  if(++batchCount == BatchSize) apuFlush();
+}
+
+auto ICD::apuFlush() -> void {
+  if(batchCount) stream->samples(batch, batchCount);
+  batchCount = 0;
 }
 
 auto ICD::joypWrite(bool p14, bool p15) -> void {
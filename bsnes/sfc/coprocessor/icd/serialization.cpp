@@ -40,4 +40,7 @@ auto ICD::serialize(serializer& s) -> void {
 
   s.integer(hcounter);
   s.integer(vcounter);
+
+  //[jsd] samples from before the load must not be heard after it:
+  if(s.mode() == serializer::Load) batchCount = 0;
 }
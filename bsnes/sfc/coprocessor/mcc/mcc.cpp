@@ -3,7 +3,7 @@
 namespace SuperFamicom {
 
 #include "serialization.cpp"
-MCC mcc;
+SFC_GLOBAL(MCC, mcc);
 
 auto MCC::unload() -> void {
   rom.reset();
@@ -2,8 +2,9 @@
 
 namespace SuperFamicom {
 
-MSU1 msu1;
+SFC_GLOBAL(MSU1, msu1);
 
+#include "reader.cpp"
 #include "serialization.cpp"
 
 auto MSU1::synchronizeCPU() -> void {
@@ -19,22 +20,24 @@ auto MSU1::Enter() -> void {
 }
 
 auto MSU1::main() -> void {
-  double left  = 0.0;
-  double right = 0.0;
+  int16 left  = 0;
+  int16 right = 0;
 
   if(io.audioPlay) {
     if(audioFile) {
-      if(audioFile->end()) {
+      if(io.audioPlayOffset >= audioFile.size()) {
         if(!io.audioRepeat) {
           io.audioPlay = false;
-          audioFile->seek(io.audioPlayOffset = 8);
+          audioSeek(io.audioPlayOffset = 8);
         } else {
-          audioFile->seek(io.audioPlayOffset = io.audioLoopOffset);
+          audioSeek(io.audioPlayOffset = io.audioLoopOffset);
         }
       } else {
+        if(block.index == block.count) audioDecode();
         io.audioPlayOffset += 4;
-        left  = (double)(int16)audioFile->readl(2) / 32768.0 * (double)io.audioVolume / 255.0;
-        right = (double)(int16)audioFile->readl(2) / 32768.0 * (double)io.audioVolume / 255.0;
+        auto sample = &block.samples[block.index++ * 2];
+        left  = sample[0];
+        right = sample[1];
         if(dsp.mute()) left = 0, right = 0;
       }
     } else {
@@ -42,23 +45,35 @@ auto MSU1::main() -> void {
     }
   }
 
-  if(!system.runAhead) stream->sample(float(left), float(right));
+  if(!system.runAhead) {
+    if(io.audioVolume != outputVolume) audioFlush(), outputVolume = io.audioVolume;
+    output.samples[output.count * 2 + 0] = left;
+    output.samples[output.count * 2 + 1] = right;
+    if(++output.count == BlockSize) audioFlush();
+  }
   step(1);
   synchronizeCPU();
 }
 
+auto MSU1::audioFlush() -> void {
+  if(output.count) stream->samples(output.samples, output.count, outputVolume / (255.0 * 32768.0));
+  output.count = 0;
+}
+
 auto MSU1::step(uint clocks) -> void {
   clock += clocks * (uint64_t)cpu.frequency;
 }
 
 auto MSU1::unload() -> void {
-  dataFile.reset();
-  audioFile.reset();
+  dataFile.close();
+  audioFile.close();
+  audioFileTrack = ~0;
 }
 
 auto MSU1::power() -> void {
   create(MSU1::Enter, 44100);
   stream = Emulator::audio.createStream(2, frequency);
+  output.count = 0;
 
   io.dataSeekOffset = 0;
   io.dataReadOffset = 0;
@@ -82,31 +97,73 @@ auto MSU1::power() -> void {
   audioOpen();
 }
 
+//[jsd] the files stay open until another one is selected, so loading a state (as run-ahead does every frame) only seeks
 auto MSU1::dataOpen() -> void {
-  dataFile.reset();
-  string name = {"msu1/data.rom"};
-  if(dataFile = platform->open(ID::SuperFamicom, name, File::Read)) {
-    dataFile->seek(io.dataReadOffset);
+  if(!dataFile) {
+    string name = {"msu1/data.rom"};
+    dataFile.open(platform->open(ID::SuperFamicom, name, File::Read));
   }
+  if(dataFile) dataFile.seek(io.dataReadOffset);
 }
 
 auto MSU1::audioOpen() -> void {
-  audioFile.reset();
-  string name = {"msu1/track-", io.audioTrack, ".pcm"};
-  if(audioFile = platform->open(ID::SuperFamicom, name, File::Read)) {
-    if(audioFile->size() >= 8) {
-      uint32 header = audioFile->readm(4);
-      if(header == 0x4d535531) {  //"MSU1"
-        io.audioLoopOffset = 8 + audioFile->readl(4) * 4;
-        if(io.audioLoopOffset > audioFile->size()) io.audioLoopOffset = 8;
-        io.audioError = false;
-        audioFile->seek(io.audioPlayOffset);
-        return;
+  auto start = chrono::nanosecond();
+  if(audioFileTrack != io.audioTrack) {
+    audioFileTrack = io.audioTrack;
+    loopBlock.count = 0;
+    string name = {"msu1/track-", io.audioTrack, ".pcm"};
+    audioFile.open(platform->open(ID::SuperFamicom, name, File::Read));
+    if(audioFile && audioFile.size() >= 8) {
+      uint8 header[8];
+      audioFile.read(header, 8);
+      if(memory::compare(header, "MSU1", 4) == 0) {
+        uint32 loop = header[4] << 0 | header[5] << 8 | header[6] << 16 | header[7] << 24;
+        io.audioLoopOffset = 8 + loop * 4;
+        if(io.audioLoopOffset > audioFile.size()) io.audioLoopOffset = 8;
+        audioFile.seek(io.audioLoopOffset);
+        audioDecode();
+        loopBlock = block;
+      } else {
+        audioFile.close();
       }
+    } else {
+      audioFile.close();
     }
-    audioFile.reset();
   }
-  io.audioError = true;
+  io.audioError = !audioFile;
+  if(!audioFile) {
+    audioFileTrack = ~0;  //try again on the next selection
+    return;
+  }
+
+  audioSeek(io.audioPlayOffset);
+  auto latency = chrono::nanosecond() - start;
+  statistics.seeks++;
+  statistics.totalNs += latency;
+  statistics.maxNs = max(statistics.maxNs, latency);
+  statistics.lastNs = latency;
+}
+
+//positions the track at offset, with the block of samples that follows it decoded already:
+auto MSU1::audioSeek(uint32 offset) -> void {
+  if(offset == io.audioLoopOffset && loopBlock.count) {
+    block = loopBlock;
+    audioFile.seek(offset + loopBlock.count * 4);
+    return;
+  }
+  audioFile.seek(offset);
+  block.index = block.count = 0;
+  if(!audioFile.end()) audioDecode();
+}
+
+auto MSU1::audioDecode() -> void {
+  uint8 buffer[BlockSize * 4];
+  uint bytes = min<uint64>(sizeof(buffer), audioFile.size() - min(audioFile.offset(), audioFile.size()));
+  bytes = bytes + 3 & ~3;  //a partial sample at the end is padded with zeroes
+  audioFile.read(buffer, bytes);
+  for(uint n : range(bytes / 2)) block.samples[n] = (int16)(buffer[n * 2 + 0] << 0 | buffer[n * 2 + 1] << 8);
+  block.index = 0;
+  block.count = bytes / 4;
 }
 
 auto MSU1::readIO(uint addr, uint8) -> uint8 {
@@ -125,9 +182,9 @@ auto MSU1::readIO(uint addr, uint8) -> uint8 {
   case 0x2001:
     if(io.dataBusy) return 0x00;
     if(!dataFile) return 0x00;
-    if(dataFile->end()) return 0x00;
+    if(dataFile.end()) return 0x00;
     io.dataReadOffset++;
-    return dataFile->read();
+    return dataFile.read();
   case 0x2002: return 'S';
   case 0x2003: return '-';
   case 0x2004: return 'M';
@@ -148,7 +205,7 @@ auto MSU1::writeIO(uint addr, uint8 data) -> void {
   case 0x2002: io.dataSeekOffset = io.dataSeekOffset & 0xff00ffff | data << 16; break;
   case 0x2003: io.dataSeekOffset = io.dataSeekOffset & 0x00ffffff | data << 24;
     io.dataReadOffset = io.dataSeekOffset;
-    if(dataFile) dataFile->seek(io.dataReadOffset);
+    if(dataFile) dataFile.seek(io.dataReadOffset);
     break;
   case 0x2004: io.audioTrack = io.audioTrack & 0xff00 | data << 0; break;
   case 0x2005: io.audioTrack = io.audioTrack & 0x00ff | data << 8;
@@ -10,15 +10,82 @@ struct MSU1 : Thread {
 
   auto dataOpen() -> void;
   auto audioOpen() -> void;
+  auto audioFlush() -> void;
 
   auto readIO(uint addr, uint8 data) -> uint8;
   auto writeIO(uint addr, uint8 data) -> void;
 
   auto serialize(serializer&) -> void;
 
+  //[jsd] time the emulation thread spent on opening an audio track or seeking in it, until its first samples could be
+  //read:
+  struct Statistics {
+    uint64 seeks = 0;
+    uint64 totalNs = 0;
+    uint64 maxNs = 0;
+    uint64 lastNs = 0;
+  } statistics;
+
 private:
-  shared_pointer<vfs::file> dataFile;
-  shared_pointer<vfs::file> audioFile;
+  //reader.cpp: reads a file sequentially without blocking the emulation thread on disk I/O. files that are held in
+  //memory as a whole (such as memory-mapped ones) are read in place; others are read ahead by a background thread into
+  //a ring buffer, which keeps some of what was already read, so that seeking back a few frames (run-ahead) is free:
+  struct Reader {
+    ~Reader() { close(); }
+
+    explicit operator bool() const { return (bool)file; }
+    auto size() const -> uint64 { return length; }
+    auto offset() const -> uint64 { return position; }
+    auto end() const -> bool { return position >= length; }
+
+    auto open(shared_pointer<vfs::file> file) -> void;
+    auto close() -> void;
+    auto seek(uint64 offset) -> void;
+    auto read() -> uint8;
+    auto read(uint8* target, uint count) -> void;
+
+  private:
+    enum : uint { RingSize = 512 * 1024, ChunkSize = 32 * 1024 };
+
+    auto prefetch() -> void;
+
+    shared_pointer<vfs::file> file;
+    const uint8* data = nullptr;
+    uint64 length = 0;
+    uint64 position = 0;
+
+    //the ring holds the file contents from windowStart to windowEnd:
+    uint8* ring = nullptr;
+    std::thread thread;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable filled;
+    std::atomic<uint64> windowStart{0};
+    std::atomic<uint64> windowEnd{0};
+    std::atomic<uint64> readOffset{0};
+    std::atomic<bool> waiting{false};
+    uint generation = 0;
+    bool stopping = false;
+  };
+
+  auto audioSeek(uint32 offset) -> void;
+  auto audioDecode() -> void;
+
+  Reader dataFile;
+  Reader audioFile;
+  uint audioFileTrack = ~0;
+
+  //samples are decoded in blocks; the first block after the loop point is kept, so looping never waits on a seek:
+  enum : uint { BlockSize = 256 };
+  struct Block {
+    int16 samples[BlockSize * 2];
+    uint index = 0;
+    uint count = 0;
+  } block, loopBlock;
+
+  //audible samples are handed to the stream a block at a time, all of them at the same volume:
+  Block output;
+  uint8 outputVolume = 0;
 
   enum Flag : uint {
     Revision       = 0x02,  //max: 0x07
@@ -50,4 +117,4 @@ private:
   } io;
 };
 
-extern MSU1 msu1;
+SFC_EXTERN(MSU1, msu1);
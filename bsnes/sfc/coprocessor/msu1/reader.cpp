@@ -0,0 +1,133 @@
+auto MSU1::Reader::open(shared_pointer<vfs::file> file) -> void {
+  close();
+  if(!file) return;
+  this->file = file;
+  data = file->data();
+  length = file->size();
+  position = 0;
+  if(data || !length) return;
+
+  ring = new uint8[RingSize];
+  windowStart = 0;
+  windowEnd = 0;
+  readOffset = 0;
+  generation = 0;
+  stopping = false;
+  thread = std::thread([this] { prefetch(); });
+}
+
+auto MSU1::Reader::close() -> void {
+  if(thread.joinable()) {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      stopping = true;
+    }
+    wake.notify_one();
+    thread.join();
+  }
+  delete[] ring;
+  ring = nullptr;
+  file.reset();
+  data = nullptr;
+  length = 0;
+  position = 0;
+}
+
+auto MSU1::Reader::seek(uint64 offset) -> void {
+  position = offset;
+  if(!ring) return;
+
+  //the oldest chunk of the window may be overwritten by the read in progress:
+  uint64 end = windowEnd;
+  uint64 start = max(windowStart.load(), end + ChunkSize > RingSize ? end + ChunkSize - RingSize : 0);
+  if(offset >= start && offset <= end) {
+    readOffset = offset;
+  } else {
+    std::lock_guard<std::mutex> lock(mutex);
+    generation++;
+    windowStart = offset;
+    windowEnd = offset;
+    readOffset = offset;
+  }
+  if(waiting) {
+    std::lock_guard<std::mutex> lock(mutex);
+    wake.notify_one();
+  }
+}
+
+auto MSU1::Reader::read() -> uint8 {
+  uint8 byte;
+  read(&byte, 1);
+  return byte;
+}
+
+//reads past the end of the file return zeroes:
+auto MSU1::Reader::read(uint8* target, uint count) -> void {
+  while(count && position < length) {
+    if(data) {
+      uint size = min<uint64>(count, length - position);
+      memory::copy(target, data + position, size);
+      target += size, count -= size, position += size;
+      break;
+    }
+
+    uint64 end = windowEnd;
+    if(position >= end) {
+      std::unique_lock<std::mutex> lock(mutex);
+      filled.wait(lock, [&] { return windowEnd > position; });
+      continue;
+    }
+
+    uint size = min<uint64>(count, end - position);
+    uint index = position % RingSize;
+    uint first = min(size, RingSize - index);
+    memory::copy(target, ring + index, first);
+    memory::copy(target + first, ring, size - first);
+    target += size, count -= size, position += size;
+    readOffset = position;
+
+    if(waiting) {
+      std::lock_guard<std::mutex> lock(mutex);
+      wake.notify_one();
+    }
+  }
+  if(count) memory::fill(target, count);
+}
+
+//runs on the background thread: keeps the window up to RingSize / 2 bytes ahead of the reader
+auto MSU1::Reader::prefetch() -> void {
+  auto chunk = new uint8[ChunkSize];
+  uint64 fileOffset = ~0ull;
+
+  std::unique_lock<std::mutex> lock(mutex);
+  while(true) {
+    waiting = true;
+    wake.wait(lock, [&] {
+      return stopping || (windowEnd < length && windowEnd - readOffset < RingSize / 2);
+    });
+    waiting = false;
+    if(stopping) break;
+
+    uint seen = generation;
+    uint64 from = windowEnd;
+    uint size = min<uint64>(ChunkSize, length - from);
+    lock.unlock();
+
+    if(fileOffset != from) file->seek(from);
+    file->read(chunk, size);
+    fileOffset = from + size;
+
+    lock.lock();
+    if(seen != generation) continue;  //the reader seeked elsewhere meanwhile
+
+    uint index = from % RingSize;
+    uint first = min(size, RingSize - index);
+    memory::copy(ring + index, chunk, first);
+    memory::copy(ring, chunk + first, size - first);
+    windowEnd = from + size;
+    if(windowEnd - windowStart > RingSize) windowStart = windowEnd - RingSize;
+    filled.notify_all();
+  }
+
+  delete[] chunk;
+}
@@ -19,6 +19,10 @@ auto MSU1::serialize(serializer& s) -> void {
   s.boolean(io.audioBusy);
   s.boolean(io.dataBusy);
 
-  dataOpen();
-  audioOpen();
+  //[jsd] saving a state does not move the files; samples from before a load must not be heard after it:
+  if(s.mode() == serializer::Load) {
+    dataOpen();
+    audioOpen();
+    output.count = 0;
+  }
 }
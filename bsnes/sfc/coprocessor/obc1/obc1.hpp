@@ -20,4 +20,4 @@ private:
   } status;
 };
 
-extern OBC1 obc1;
+SFC_EXTERN(OBC1, obc1);
@@ -57,8 +57,9 @@ struct SA1 : Processor::WDC65816, Thread {
     //rom.cpp
     alwaysinline auto conflict() const -> bool;
 
-    alwaysinline auto read(uint address, uint8 data = 0) -> uint8 override;
-    alwaysinline auto write(uint address, uint8 data) -> void override;
+    //[jsd] not inline: an Instance constructs SA1 outside of sa1.cpp, which emits the vtable of ROM there
+    auto read(uint address, uint8 data = 0) -> uint8 override;
+    auto write(uint address, uint8 data) -> void override;
 
     auto readCPU(uint address, uint8 data = 0) -> uint8;
     auto writeCPU(uint address, uint8 data) -> void;
@@ -71,8 +72,9 @@ struct SA1 : Processor::WDC65816, Thread {
     //bwram.cpp
     alwaysinline auto conflict() const -> bool;
 
-    alwaysinline auto read(uint address, uint8 data = 0) -> uint8 override;
-    alwaysinline auto write(uint address, uint8 data) -> void override;
+    //[jsd] not inline: an Instance constructs SA1 outside of sa1.cpp, which emits the vtable of ROM there
+    auto read(uint address, uint8 data = 0) -> uint8 override;
+    auto write(uint address, uint8 data) -> void override;
 
     auto readCPU(uint address, uint8 data = 0) -> uint8;
     auto writeCPU(uint address, uint8 data) -> void;
@@ -93,8 +95,9 @@ struct SA1 : Processor::WDC65816, Thread {
     //iram.cpp
     alwaysinline auto conflict() const -> bool;
 
-    alwaysinline auto read(uint address, uint8 data = 0) -> uint8 override;
-    alwaysinline auto write(uint address, uint8 data) -> void override;
+    //[jsd] not inline: an Instance constructs SA1 outside of sa1.cpp, which emits the vtable of ROM there
+    auto read(uint address, uint8 data = 0) -> uint8 override;
+    auto write(uint address, uint8 data) -> void override;
 
     auto readCPU(uint address, uint8 data) -> uint8;
     auto writeCPU(uint address, uint8 data) -> void;
@@ -284,4 +287,4 @@ private:
   } mmio;
 };
 
-extern SA1 sa1;
+SFC_EXTERN(SA1, sa1);
@@ -36,4 +36,4 @@ public:
   Decompressor decompressor;
 };
 
-extern SDD1 sdd1;
+SFC_EXTERN(SDD1, sdd1);
@@ -43,4 +43,4 @@ struct SharpRTC : Thread {
   auto calculateWeekday(uint year, uint month, uint day) -> uint;
 };
 
-extern SharpRTC sharprtc;
+SFC_EXTERN(SharpRTC, sharprtc);
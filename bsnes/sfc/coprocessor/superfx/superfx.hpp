@@ -74,4 +74,4 @@ private:
   uint ramMask;
 };
 
-extern SuperFX superfx;
+SFC_EXTERN(SuperFX, superfx);
@@ -2,7 +2,7 @@
 
 namespace SuperFamicom {
 
-CPU cpu;
+SFC_GLOBAL(CPU, cpu);
 #include "dma.cpp"
 #include "memory.cpp"
 #include "io.cpp"
@@ -35,26 +35,53 @@ auto CPU::register_pc_callback(
   uint32 addr,
   const function<void (uint32 addr)> &callback
 ) -> void {
+  addr &= 0xffffff;
+  auto& page = pc_callback_pages[addr >> 16];
+  if(!page) page = new uint8[0x10000 >> 3]();
+  page[(addr & 0xffff) >> 3] |= 1 << (addr & 7);
+
+  pc_callbacks.remove(addr);
   pc_callbacks.insert(addr, callback);
 }
 
 auto CPU::unregister_pc_callback(
   uint32 addr
 ) -> void {
+  addr &= 0xffffff;
+  if(auto& page = pc_callback_pages[addr >> 16]) {
+    page[(addr & 0xffff) >> 3] &= ~(1 << (addr & 7));
+    //free the page once its bank has no callbacks left:
+    bool empty = true;
+    for(uint n : range(0x10000 >> 3)) if(page[n]) { empty = false; break; }
+    if(empty) delete[] page, page = nullptr;
+  }
+
   pc_callbacks.remove(addr);
 }
 
 auto CPU::reset_pc_callbacks() -> void {
+  for(auto& page : pc_callback_pages) {
+    delete[] page;
+    page = nullptr;
+  }
+
   pc_callbacks.reset();
 }
 
+auto CPU::has_pc_callback(uint addr) const -> bool {
+  auto page = pc_callback_pages[addr >> 16];
+  return page && (page[(addr & 0xffff) >> 3] >> (addr & 7) & 1);
+}
+
 auto CPU::main() -> void {
   if(r.wai) return instructionWait();
   if(r.stp) return instructionStop();
   if(!status.interruptPending) {
-    auto intr = pc_callbacks.find(r.pc.d);
-    if (intr) {
-      intr()(r.pc.d);
+    // only search the callback map when the bitmap says this pc has a callback:
+    if (pc_callbacks.size() && has_pc_callback(r.pc.d)) {
+      if (auto intr = pc_callbacks.find(r.pc.d)) {
+        intr()(r.pc.d);
+      }
     }
     return instruction();
   }
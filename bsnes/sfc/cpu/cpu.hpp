@@ -4,6 +4,8 @@ struct CPU : Processor::WDC65816, Thread, PPUcounter {
   inline auto refresh() const -> bool { return status.dramRefresh == 1; }
   inline auto synchronizing() const -> bool override { return scheduler.synchronizing(); }
 
+  ~CPU() { reset_pc_callbacks(); }
+
   //cpu.cpp
   auto synchronizeSMP() -> void;
   auto synchronizePPU() -> void;
@@ -112,7 +114,12 @@ struct CPU : Processor::WDC65816, Thread, PPUcounter {
     uint32 addr
   ) -> void;
   auto reset_pc_callbacks() -> void;
+  alwaysinline auto has_pc_callback(uint addr) const -> bool;
   map< uint32, function<void (uint32 addr)> > pc_callbacks;
+  // bank-paged bitmap of addresses with a registered pc callback; pages are only allocated for banks that have one:
+  uint8* pc_callback_pages[256] = {};
+  // [jsd] hcounter of the next script callback timed to a position on the current scanline; ~0 if there is none:
+  uint rasterPosition = ~0u;
 
   uint8 wram[128 * 1024];
   vector<Thread*> coprocessors;
@@ -289,4 +296,4 @@ private:
   function<void (const CPU::DMAIntercept &)> dma_interceptor;
 };
 
-extern CPU cpu;
+SFC_EXTERN(CPU, cpu);
@@ -76,6 +76,9 @@ auto CPU::step() -> void {
     }
   }
 
+  // [jsd] run script callbacks registered for an H/V position once it is reached:
+  if(hcounter() >= rasterPosition) rasterPosition = ScriptInterface::deliverRasterEvents(hcounter());
+
   if constexpr(Synchronize) {
     if(configuration.hacks.coprocessor.delayedSync) return;
     synchronizeCoprocessors();
@@ -100,6 +103,13 @@ auto CPU::scanline() -> void {
   synchronizePPU();
   synchronizeCoprocessors();
 
+  // [jsd] deliver buffered write interceptor events to scripts:
+  if(script.writeEvents) ScriptInterface::deliverWriteEvents(vcounter());
+  // [jsd] deliver network ready events to scripts:
+  if(script.netEvents) ScriptInterface::deliverNetEvents(vcounter());
+  // [jsd] run script callbacks registered for this scanline; only scanlines with callbacks set a position to check:
+  rasterPosition = script.rasterEvents ? ScriptInterface::deliverScanlineEvents(vcounter(), hcounter()) : ~0u;
+
   if(vcounter() == 0) {
     //HDMA setup triggers once every frame
     status.hdmaSetupPosition = (version == 1 ? 12 + 8 - dmaCounter() : 12 + dmaCounter());
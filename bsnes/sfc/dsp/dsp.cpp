@@ -2,7 +2,7 @@
 
 namespace SuperFamicom {
 
-DSP dsp;
+SFC_GLOBAL(DSP, dsp);
 
 #include "serialization.cpp"
 #include "SPC_DSP.cpp"
@@ -20,14 +20,19 @@ auto DSP::main() -> void {
   if(count > 0) {
     if(!system.runAhead)
     for(uint n = 0; n < count; n += 2) {
-      float left  = samplebuffer[n + 0] / 32768.0f;
-      float right = samplebuffer[n + 1] / 32768.0f;
-      stream->sample(left, right);
+      batch[batchCount * 2 + 0] = samplebuffer[n + 0];
+      batch[batchCount * 2 + 1] = samplebuffer[n + 1];
+      if(++batchCount == BatchSize) flushSamples();
     }
     spc_dsp.set_output(samplebuffer, 8192);
   }
 }
 
+auto DSP::flushSamples() -> void {
+  if(batchCount) stream->samples(batch, batchCount);
+  batchCount = 0;
+}
+
 auto DSP::read(uint8 address) -> uint8 {
   return spc_dsp.read(address);
 }
@@ -48,6 +53,7 @@ auto DSP::load() -> bool {
 
 auto DSP::power(bool reset) -> void {
   clock = 0;
+  batchCount = 0;
   stream = Emulator::audio.createStream(2, system.apuFrequency() / 768.0);
 
   if(!reset) {
@@ -5,6 +5,7 @@ struct DSP {
   uint8 apuram[64 * 1024] = {};
 
   auto main() -> void;
+  auto flushSamples() -> void;
   auto read(uint8 address) -> uint8;
   auto write(uint8 address, uint8 data) -> void;
 
@@ -23,6 +24,11 @@ private:
 
 //unserialized:
   uint8 echoram[64 * 1024] = {};
+
+  //[jsd] audible samples are handed to the stream in batches, so it filters and resamples them as a block:
+  enum : uint { BatchSize = 128 };
+  int16 batch[BatchSize * 2];
+  uint batchCount = 0;
 };
 
-extern DSP dsp;
+SFC_EXTERN(DSP, dsp);
@@ -22,6 +22,7 @@ auto DSP::serialize(serializer& s) -> void {
   } else if(s.mode() == serializer::Load) {
     s.array(state);
     spc_dsp.copy_state(&p, dsp_state_load);
+    batchCount = 0;  //[jsd] samples from before the load must not be heard after it
   } else {
     s.array(state);
   }
@@ -4,7 +4,7 @@
 
 namespace SuperFamicom {
 
-ExpansionPort expansionPort;
+SFC_GLOBAL(ExpansionPort, expansionPort);
 
 Expansion::Expansion() {
 }
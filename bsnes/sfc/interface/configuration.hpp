@@ -41,6 +41,7 @@ struct Configuration {
       bool noSpriteLimit = false;
       bool noVRAMBlocking = false;
       uint threads = 0;
+      uint threadSpin = 50;
       uint renderCycle = 512;
       struct Mode7 {
         uint scale = 1;
@@ -66,6 +67,10 @@ struct Configuration {
     } superfx;
   } hacks;
 
+  struct StateExport {
+    string name;  //shared memory segment WRAM, VRAM, CGRAM, OAM and CPU registers are exported to; empty to disable
+  } stateExport;
+
 private:
   auto process(Markup::Node document, bool load) -> void;
 };
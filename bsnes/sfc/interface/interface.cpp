@@ -3,6 +3,7 @@
 
 // [jsd] for scripts
 #include <hiro/hiro.hpp>
+#include <nall/decode/inflate.hpp>
 #include <nall/encode/base64.hpp>
 #include <nall/thread.hpp>
 #include "sha1.hpp"
@@ -13,7 +14,7 @@
 
 namespace SuperFamicom {
 
-Settings settings;
+SFC_GLOBAL(Settings, settings);
 #include "configuration.cpp"
 #include "script-interface.cpp"
 
@@ -252,10 +253,13 @@ auto Interface::synchronize(uint64 timestamp) -> void {
 }
 
 auto Interface::serialize(bool synchronize) -> serializer {
+  // [jsd] the state saved during run-ahead is loaded again after the speculative frames that follow:
+  if(system.runAhead) ScriptInterface::runAheadSave();
   return system.serialize(synchronize);
 }
 
 auto Interface::unserialize(serializer& s) -> bool {
+  if(script.speculative) ScriptInterface::runAheadLoad();
   return system.unserialize(s);
 }
 
@@ -269,55 +273,22 @@ auto Interface::cheats(const vector<string>& list) -> void {
     return;
   }
 
-  //make all ROM data writable temporarily
-  Memory::GlobalWriteEnable = true;
-
-  Cheat oldCheat = cheat;
-  Cheat newCheat;
-  newCheat.assign(list);
-
-  //determine all old codes to remove
-  for(auto& oldCode : oldCheat.codes) {
-    bool found = false;
-    for(auto& newCode : newCheat.codes) {
-      if(oldCode == newCode) {
-        found = true;
-        break;
-      }
-    }
-    if(!found) {
-      //remove old cheat
-      if(oldCode.enable) {
-        bus.write(oldCode.address, oldCode.restore);
-      }
+  //[jsd] codes for WRAM are written into it once per frame, as an Action Replay does. every other code replaces what
+  //the CPU reads from its address while its compare value matches, as a Game Genie does (see Bus::read):
+  cheat.reset();
+  bus.cheats.reset();
+  Cheat codes;
+  codes.assign(list);
+  for(auto& code : codes.codes) {
+    uint bank = code.address >> 16 & 0xff, offset = code.address & 0xffff;
+    if(bank == 0x7e || bank == 0x7f) {
+      cheat.append(code.address & 0x1ffff, code.data, code.compare);
+    } else if((bank & 0x40) == 0 && offset < 0x2000) {
+      cheat.append(offset, code.data, code.compare);
+    } else {
+      bus.cheats.append(code.address & 0xffffff, code.data, code.compare);
     }
   }
-
-  //determine all new codes to create
-  for(auto& newCode : newCheat.codes) {
-    bool found = false;
-    for(auto& oldCode : oldCheat.codes) {
-      if(newCode == oldCode) {
-        found = true;
-        break;
-      }
-    }
-    if(!found) {
-      //create new cheat
-      newCode.restore = bus.read(newCode.address);
-      if(!newCode.compare || newCode.compare() == newCode.restore) {
-        newCode.enable = true;
-        bus.write(newCode.address, newCode.data);
-      } else {
-        newCode.enable = false;
-      }
-    }
-  }
-
-  cheat = newCheat;
-
-  //restore ROM write protection
-  Memory::GlobalWriteEnable = false;
 }
 
 auto Interface::configuration() -> string {
@@ -93,6 +93,6 @@ struct Settings {
   bool random = true;
 };
 
-extern Settings settings;
+SFC_EXTERN(Settings, settings);
 
 }
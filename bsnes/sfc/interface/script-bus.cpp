@@ -1,4 +1,63 @@
 
+struct WriteEvent {
+  uint32 addr;
+  uint8  value;
+  uint16 vcounter;
+  uint16 hcounter;
+  uint32 pc;
+};
+
+// preallocated buffer of intercepted writes delivered to the script in one call per frame (at `scanline`). reference
+// counted, as the script may keep the handle it was given:
+struct WriteEventQueue {
+  asIScriptFunction *cb;
+  uint scanline;
+  uint ref = 1;
+
+  WriteEvent *events;
+  uint capacity;
+  uint count = 0;
+  uint dropped = 0;
+
+  WriteEventQueue(asIScriptFunction *cb, uint scanline, uint capacity)
+    : cb(cb), scanline(scanline), capacity(capacity)
+  {
+    cb->AddRef();
+    events = new WriteEvent[capacity];
+  }
+  ~WriteEventQueue() {
+    delete[] events;
+    cb->Release();
+  }
+
+  auto addRef() -> void { ref++; }
+  auto release() -> void { if (--ref == 0) delete this; }
+
+  auto get_length() -> uint { return count; }
+  auto get_dropped() -> uint { return dropped; }
+
+  auto get_opIndex(uint i) -> WriteEvent* {
+    if (i >= count) {
+      asGetActiveContext()->SetException("index out of range", true);
+      return nullptr;
+    }
+    return &events[i];
+  }
+
+  auto deliver() -> void {
+    if (count == 0 && dropped == 0) return;
+
+    executeCallback(cb, [this](asIScriptContext *ctx) {
+      ctx->SetArgObject(0, (void *)this);
+    });
+
+    count = 0;
+    dropped = 0;
+  }
+};
+// each queue holds one reference for this list:
+vector<WriteEventQueue*> writeEventQueues;
+
 struct Bus {
   static auto read_u8(uint32 addr) -> uint8 {
     return ::SuperFamicom::bus.read(addr, 0);
@@ -164,17 +223,69 @@ struct Bus {
     }
 
     auto operator()(uint addr, uint8 new_value) -> void {
-      auto ctx = ::SuperFamicom::script.context;
-      //printf("call() this=%p ctx=%p cb=%p\n", this, ctx, cb);
-      ctx->Prepare(cb);
-      ctx->SetArgDWord(0, addr);
-      ctx->SetArgByte(1, new_value);
-      executeScript(ctx);
+      executeCallback(cb, [=](asIScriptContext *ctx) {
+        ctx->SetArgDWord(0, addr);
+        ctx->SetArgByte(1, new_value);
+      });
     }
   };
 
   static auto add_write_interceptor(const string *addr, uint32 size, asIScriptFunction *cb) -> void {
-    ::SuperFamicom::bus.add_write_interceptor(*addr, size, write_interceptor(cb));
+    auto id = ::SuperFamicom::bus.add_write_interceptor(*addr, size, write_interceptor(cb));
+    hooks.track(cb, {"bus:", id}, [=] { ::SuperFamicom::bus.remove_interceptor(id); });
+  }
+
+  struct buffered_write_interceptor {
+    WriteEventQueue *queue;
+
+    buffered_write_interceptor(WriteEventQueue *queue) : queue(queue) {
+      queue->addRef();
+    }
+    buffered_write_interceptor(const buffered_write_interceptor& other) : queue(other.queue) {
+      queue->addRef();
+    }
+    ~buffered_write_interceptor() {
+      queue->release();
+    }
+
+    auto operator()(uint addr, uint8 new_value) -> void {
+      auto& q = *queue;
+      // writes of speculative frames would be delivered after they were rolled back:
+      if (::SuperFamicom::script.speculative && skipSpeculative(q.cb)) return;
+      if (q.count >= q.capacity) {
+        q.dropped++;
+        return;
+      }
+
+      auto& event = q.events[q.count++];
+      event.addr = addr;
+      event.value = new_value;
+      event.vcounter = ::SuperFamicom::cpu.vcounter();
+      event.hcounter = ::SuperFamicom::cpu.hcounter();
+      event.pc = ::SuperFamicom::cpu.r.pc.d;
+    }
+  };
+
+  static auto add_buffered_write_interceptor(const string *addr, uint32 size, asIScriptFunction *cb, uint16 scanline, uint capacity) -> void {
+    if (capacity == 0) {
+      asGetActiveContext()->SetException("capacity must be greater than zero", true);
+      return;
+    }
+
+    auto queue = new WriteEventQueue(cb, scanline, capacity);
+    writeEventQueues.append(queue);
+    ::SuperFamicom::script.writeEvents = true;
+
+    auto id = ::SuperFamicom::bus.add_write_interceptor(*addr, size, buffered_write_interceptor(queue));
+    // the pointer is only compared here; the queue may already be gone after resetWriteEvents():
+    hooks.track(cb, {"bus:", id}, [=] {
+      ::SuperFamicom::bus.remove_interceptor(id);
+      if (auto index = writeEventQueues.find(queue)) {
+        writeEventQueues.remove(*index);
+        queue->release();
+      }
+      ::SuperFamicom::script.writeEvents = (bool)writeEventQueues;
+    });
   }
 
   struct dma_interceptor {
@@ -193,15 +304,15 @@ struct Bus {
     }
 
     auto operator()(const CPU::DMAIntercept &dma) -> void {
-      auto ctx = ::SuperFamicom::script.context;
-      ctx->Prepare(cb);
-      ctx->SetArgObject(0, (void *)&dma);
-      executeScript(ctx);
+      executeCallback(cb, [&](asIScriptContext *ctx) {
+        ctx->SetArgObject(0, (void *)&dma);
+      });
     }
   };
 
   static auto register_dma_interceptor(asIScriptFunction *cb) -> void {
     ::SuperFamicom::cpu.register_dma_interceptor(dma_interceptor(cb));
+    hooks.track(cb, "dma", [] { ::SuperFamicom::cpu.reset_dma_interceptor(); });
   }
 
   struct pc_interceptor {
@@ -220,22 +331,119 @@ struct Bus {
     }
 
     auto operator()(uint32 addr) -> void {
-      auto ctx = ::SuperFamicom::script.context;
-      ctx->Prepare(cb);
-      ctx->SetArgDWord(0, addr);
-      executeScript(ctx);
+      executeCallback(cb, [=](asIScriptContext *ctx) {
+        ctx->SetArgDWord(0, addr);
+      });
     }
   };
 
   static auto register_pc_interceptor(uint32 addr, asIScriptFunction *cb) -> void {
     ::SuperFamicom::cpu.register_pc_callback(addr, pc_interceptor(cb));
+    hooks.track(cb, {"pc:", addr & 0xffffff}, [=] { ::SuperFamicom::cpu.unregister_pc_callback(addr); });
   }
 
   static auto unregister_pc_interceptor(uint32 addr) -> void {
     ::SuperFamicom::cpu.unregister_pc_callback(addr);
+    hooks.untrack({"pc:", addr & 0xffffff});
   }
 } bus;
 
+auto deliverWriteEvents(uint vcounter) -> void {
+  for (uint i = 0; i < writeEventQueues.size(); i++) {
+    auto queue = writeEventQueues[i];
+    if (queue->scanline != vcounter) continue;
+
+    // the callback may add or remove interceptors; keep this queue alive and continue after wherever it is now:
+    queue->addRef();
+    queue->deliver();
+    if (i >= writeEventQueues.size() || writeEventQueues[i] != queue) {
+      auto index = writeEventQueues.find(queue);
+      i = index ? *index : i - 1;
+    }
+    queue->release();
+  }
+}
+
+auto resetWriteEvents() -> void {
+  for (auto queue : writeEventQueues) queue->release();
+  writeEventQueues.reset();
+  ::SuperFamicom::script.writeEvents = false;
+}
+
+// direct views of backing memory that bypass the bus reader/target dispatch:
+struct MemoryView {
+  // either a fixed buffer (e.g. WRAM) or a Memory whose data may be reallocated (e.g. cartridge ROM/SRAM):
+  uint8  *fixedData;
+  uint    fixedSize;
+  Memory *memory;
+
+  MemoryView(uint8 *data, uint size) : fixedData(data), fixedSize(size), memory(nullptr) {}
+  MemoryView(Memory &memory) : fixedData(nullptr), fixedSize(0), memory(&memory) {}
+
+  alwaysinline auto data() -> uint8* { return memory ? memory->data() : fixedData; }
+  alwaysinline auto size() -> uint { return memory ? memory->size() : fixedSize; }
+
+  auto inBounds(uint32 addr, uint32 count) -> bool {
+    if (uint64(addr) + count > size()) {
+      asGetActiveContext()->SetException("address out of range of memory view", true);
+      return false;
+    }
+    return true;
+  }
+
+  auto get_size() -> uint32 {
+    return size();
+  }
+
+  auto read_u8(uint32 addr) -> uint8 {
+    if (!inBounds(addr, 1)) return 0;
+    return data()[addr];
+  }
+
+  auto read_u16(uint32 addr) -> uint16 {
+    if (!inBounds(addr, 2)) return 0;
+    auto p = data() + addr;
+    return uint16(p[0]) | (uint16(p[1]) << 8u);
+  }
+
+  auto read_u24(uint32 addr) -> uint32 {
+    if (!inBounds(addr, 3)) return 0;
+    auto p = data() + addr;
+    return uint32(p[0]) | (uint32(p[1]) << 8u) | (uint32(p[2]) << 16u);
+  }
+
+  // copies `size` elements starting at `addr` into output[offs..offs+size-1]; uint16 elements are read little-endian:
+  auto copy_to(uint32 addr, uint offs, uint size, CScriptArray *output) -> void {
+    if (output == nullptr) {
+      asGetActiveContext()->SetException("output array cannot be null", true);
+      return;
+    }
+
+    uint elementSize;
+    auto typeId = output->GetElementTypeId();
+    if (typeId == asTYPEID_UINT8) {
+      elementSize = 1;
+    } else if (typeId == asTYPEID_UINT16) {
+      elementSize = 2;
+    } else {
+      asGetActiveContext()->SetException("output array must be of type uint8[] or uint16[]", true);
+      return;
+    }
+    if (uint64(offs) + size > output->GetSize()) {
+      asGetActiveContext()->SetException("offset and size exceed the bounds of the output array", true);
+      return;
+    }
+    if (!inBounds(addr, size * elementSize)) return;
+    if (size == 0) return;
+
+    memory::copy(output->At(offs), data() + addr, size * elementSize);
+  }
+};
+
+MemoryView wramView(cpu.wram, sizeof(cpu.wram));
+MemoryView sramView(cartridge.ram);
+MemoryView romView(cartridge.rom);
+
 auto RegisterBus(asIScriptEngine *e) -> void {
   int r;
 
@@ -260,6 +468,37 @@ auto RegisterBus(asIScriptEngine *e) -> void {
 
     r = e->RegisterFuncdef("void WriteInterceptCallback(uint32 addr, uint8 value)"); assert(r >= 0);
     r = e->RegisterGlobalFunction("void add_write_interceptor(const string &in addr, uint32 size, WriteInterceptCallback @cb)", asFUNCTION(Bus::add_write_interceptor), asCALL_CDECL); assert(r >= 0);
+
+    // buffered write interception:
+    r = e->RegisterObjectType    ("WriteEvent", sizeof(WriteEvent), asOBJ_REF | asOBJ_NOCOUNT); assert(r >= 0);
+    r = e->RegisterObjectProperty("WriteEvent", "uint32 addr", asOFFSET(WriteEvent, addr)); assert(r >= 0);
+    r = e->RegisterObjectProperty("WriteEvent", "uint8  value", asOFFSET(WriteEvent, value)); assert(r >= 0);
+    r = e->RegisterObjectProperty("WriteEvent", "uint16 vcounter", asOFFSET(WriteEvent, vcounter)); assert(r >= 0);
+    r = e->RegisterObjectProperty("WriteEvent", "uint16 hcounter", asOFFSET(WriteEvent, hcounter)); assert(r >= 0);
+    r = e->RegisterObjectProperty("WriteEvent", "uint32 pc", asOFFSET(WriteEvent, pc)); assert(r >= 0);
+
+    r = e->RegisterObjectType  ("WriteEvents", 0, asOBJ_REF); assert(r >= 0);
+    r = e->RegisterObjectBehaviour("WriteEvents", asBEHAVE_ADDREF, "void f()", asMETHOD(WriteEventQueue, addRef), asCALL_THISCALL); assert(r >= 0);
+    r = e->RegisterObjectBehaviour("WriteEvents", asBEHAVE_RELEASE, "void f()", asMETHOD(WriteEventQueue, release), asCALL_THISCALL); assert(r >= 0);
+    r = e->RegisterObjectMethod("WriteEvents", "uint get_length() property", asMETHOD(WriteEventQueue, get_length), asCALL_THISCALL); assert(r >= 0);
+    r = e->RegisterObjectMethod("WriteEvents", "uint get_dropped() property", asMETHOD(WriteEventQueue, get_dropped), asCALL_THISCALL); assert(r >= 0);
+    r = e->RegisterObjectMethod("WriteEvents", "WriteEvent @get_opIndex(uint i) property", asMETHOD(WriteEventQueue, get_opIndex), asCALL_THISCALL); assert(r >= 0);
+
+    r = e->RegisterFuncdef("void WriteEventsCallback(WriteEvents @events)"); assert(r >= 0);
+    r = e->RegisterGlobalFunction("void add_buffered_write_interceptor(const string &in addr, uint32 size, WriteEventsCallback @cb, uint16 scanline = 0, uint capacity = 4096)", asFUNCTION(Bus::add_buffered_write_interceptor), asCALL_CDECL); assert(r >= 0);
+
+    // direct memory views:
+    r = e->RegisterObjectType("MemoryView", 0, asOBJ_REF | asOBJ_NOHANDLE); assert(r >= 0);
+    r = e->RegisterObjectMethod("MemoryView", "uint32 get_size() property", asMETHOD(MemoryView, get_size), asCALL_THISCALL); assert(r >= 0);
+    r = e->RegisterObjectMethod("MemoryView", "uint8 opIndex(uint32 addr)", asMETHOD(MemoryView, read_u8), asCALL_THISCALL); assert(r >= 0);
+    r = e->RegisterObjectMethod("MemoryView", "uint8 get_u8(uint32 addr) property", asMETHOD(MemoryView, read_u8), asCALL_THISCALL); assert(r >= 0);
+    r = e->RegisterObjectMethod("MemoryView", "uint16 get_u16(uint32 addr) property", asMETHOD(MemoryView, read_u16), asCALL_THISCALL); assert(r >= 0);
+    r = e->RegisterObjectMethod("MemoryView", "uint32 get_u24(uint32 addr) property", asMETHOD(MemoryView, read_u24), asCALL_THISCALL); assert(r >= 0);
+    r = e->RegisterObjectMethod("MemoryView", "void copy_to(uint32 addr, uint offs, uint size, array<uint8> &inout output)", asMETHOD(MemoryView, copy_to), asCALL_THISCALL); assert(r >= 0);
+    r = e->RegisterObjectMethod("MemoryView", "void copy_to(uint32 addr, uint offs, uint size, array<uint16> &inout output)", asMETHOD(MemoryView, copy_to), asCALL_THISCALL); assert(r >= 0);
+    r = e->RegisterGlobalProperty("MemoryView wram", &wramView); assert(r >= 0);
+    r = e->RegisterGlobalProperty("MemoryView sram", &sramView); assert(r >= 0);
+    r = e->RegisterGlobalProperty("MemoryView rom", &romView); assert(r >= 0);
   }
 
   {
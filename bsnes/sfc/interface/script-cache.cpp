@@ -0,0 +1,144 @@
+// caches compiled script bytecode so that unchanged scripts skip Build() on load and reload. A cache entry is keyed by
+// a hash of the script sources together with a hash of the registered script API, so that changes to either the
+// scripts or the emulator invalidate it.
+struct BytecodeCache {
+  static auto append(vector<uint8_t> &buffer, const void *data, uint size) -> void {
+    uint offset = buffer.size();
+    buffer.resize(offset + size);
+    memory::copy(buffer.data() + offset, data, size);
+  }
+
+  struct Stream : asIBinaryStream {
+    vector<uint8_t> &buffer;
+    uint offset;
+
+    Stream(vector<uint8_t> &buffer, uint offset = 0) : buffer(buffer), offset(offset) {}
+
+    int Read(void *ptr, asUINT size) override {
+      if (offset + size > buffer.size()) return asERROR;
+      memory::copy(ptr, buffer.data() + offset, size);
+      offset += size;
+      return asSUCCESS;
+    }
+
+    int Write(const void *ptr, asUINT size) override {
+      append(buffer, ptr, size);
+      return asSUCCESS;
+    }
+  };
+
+  static constexpr const char *Signature = "bsnes-asbc";
+
+  bool enabled = true;
+  string api;  // hash of the registered script API
+
+  // hashes every declaration registered with the engine:
+  auto hashAPI(asIScriptEngine *engine) -> void {
+    Hash::SHA256 hash;
+    auto add = [&](const char *text) {
+      if (text) hash.input(text, strlen(text));
+      hash.input((uint8_t)'\n');
+    };
+    auto addType = [&](asITypeInfo *type) {
+      add(type->GetNamespace());
+      add(type->GetName());
+      add(string{type->GetFlags(), ",", type->GetSize()});
+      for (uint i : range(type->GetFactoryCount())) add(type->GetFactoryByIndex(i)->GetDeclaration(true, true, true));
+      for (uint i : range(type->GetBehaviourCount())) add(type->GetBehaviourByIndex(i, nullptr)->GetDeclaration(true, true, true));
+      for (uint i : range(type->GetMethodCount())) add(type->GetMethodByIndex(i)->GetDeclaration(true, true, true));
+      for (uint i : range(type->GetPropertyCount())) add(type->GetPropertyDeclaration(i, true));
+      for (uint i : range(type->GetChildFuncdefCount())) add(type->GetChildFuncdef(i)->GetFuncdefSignature()->GetDeclaration(true, true, true));
+    };
+
+    add(ANGELSCRIPT_VERSION_STRING);
+    add(asGetLibraryOptions());
+    for (uint i : range(engine->GetGlobalFunctionCount())) {
+      add(engine->GetGlobalFunctionByIndex(i)->GetDeclaration(true, true, true));
+    }
+    for (uint i : range(engine->GetGlobalPropertyCount())) {
+      const char *name, *ns;
+      int typeId;
+      bool isConst;
+      engine->GetGlobalPropertyByIndex(i, &name, &ns, &typeId, &isConst);
+      add(ns);
+      add(name);
+      add(engine->GetTypeDeclaration(typeId, true));
+      add(isConst ? "const" : "");
+    }
+    for (uint i : range(engine->GetObjectTypeCount())) addType(engine->GetObjectTypeByIndex(i));
+    for (uint i : range(engine->GetEnumCount())) {
+      auto type = engine->GetEnumByIndex(i);
+      add(type->GetNamespace());
+      add(type->GetName());
+      for (uint j : range(type->GetEnumValueCount())) {
+        int value;
+        add(type->GetEnumValueByIndex(j, &value));
+        add(string{value});
+      }
+    }
+    for (uint i : range(engine->GetFuncdefCount())) {
+      add(engine->GetFuncdefByIndex(i)->GetFuncdefSignature()->GetDeclaration(true, true, true));
+    }
+    for (uint i : range(engine->GetTypedefCount())) {
+      auto type = engine->GetTypedefByIndex(i);
+      add(type->GetNamespace());
+      add(type->GetName());
+      add(engine->GetTypeDeclaration(type->GetTypedefTypeId(), true));
+    }
+
+    api = hash.digest();
+  }
+
+  // one cache file per script location; it is overwritten whenever the scripts change:
+  auto path(const string &location) -> string {
+    return {Path::userData(), "bsnes/script-cache/", Hash::SHA256(location).digest().slice(0, 16), ".asbc"};
+  }
+
+  auto key(asIScriptEngine *engine, const vector<string> &names, const vector<string> &sources) -> string {
+    Hash::SHA256 hash;
+    hash.input(api);
+    // bytecode built for a JIT compiler contains additional instructions:
+    hash.input((uint8_t)engine->GetEngineProperty(asEP_INCLUDE_JIT_INSTRUCTIONS));
+    for (uint i : range(names.size())) {
+      hash.input((uint8_t)0);
+      hash.input(names[i]);
+      hash.input((uint8_t)0);
+      hash.input(sources[i]);
+    }
+    return hash.digest();
+  }
+
+  // returns the cache file if it was saved for the given key; safe to call from any thread:
+  auto read(const string &location, const string &key) -> vector<uint8_t> {
+    if (!enabled) return {};
+
+    auto buffer = file::read(path(location));
+    uint header = strlen(Signature) + key.size();
+    if (buffer.size() <= header) return {};
+    if (memory::compare(buffer.data(), Signature, strlen(Signature))) return {};
+    if (memory::compare(buffer.data() + strlen(Signature), key.data(), key.size())) return {};
+    return buffer;
+  }
+
+  auto load(asIScriptModule *module, vector<uint8_t> &buffer, const string &key) -> bool {
+    if (!buffer) return false;
+
+    Stream stream{buffer, uint(strlen(Signature) + key.size())};
+    return module->LoadByteCode(&stream) >= 0;
+  }
+
+  auto save(asIScriptModule *module, const string &location, const string &key) -> void {
+    if (!enabled) return;
+
+    vector<uint8_t> buffer;
+    append(buffer, Signature, strlen(Signature));
+    append(buffer, key.data(), key.size());
+
+    Stream stream{buffer};
+    if (module->SaveByteCode(&stream) < 0) return;
+
+    auto filename = path(location);
+    directory::create(Location::path(filename));
+    file::write(filename, buffer);
+  }
+} bytecodeCache;
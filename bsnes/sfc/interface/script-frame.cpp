@@ -24,6 +24,95 @@ struct PostFrame {
     op_xor,
   } draw_op = op_solid;
 
+  // blend source pixels into the frame with the given draw_op; source pixels with bit 15 set are transparent.
+  // Alpha blending divides by 31 with a multiply: (x * 2115) >> 16 == x / 31 for every x <= 31 * 31.
+  static auto blend_pixel(r5g5b5 &d, r5g5b5 s, draw_op_t op, uint alpha) -> void {
+    if (s & 0x8000u) return;
+    switch (op) {
+      case op_alpha: {
+        uint ia = 31u - alpha;
+        uint b = ((s & 0x001fu) * alpha + (d & 0x001fu) * ia) * 2115u >> 16u;
+        uint g = ((s >> 5u & 0x1fu) * alpha + (d >> 5u & 0x1fu) * ia) * 2115u >> 16u;
+        uint r = ((s >> 10u & 0x1fu) * alpha + (d >> 10u & 0x1fu) * ia) * 2115u >> 16u;
+        d = b | g << 5u | r << 10u;
+        break;
+      }
+      case op_xor:
+        d ^= s;
+        break;
+      case op_solid:
+      default:
+        d = s;
+        break;
+    }
+  }
+
+#if defined(SIMD_AVX2)
+  static auto blend_row(r5g5b5 *dst, const r5g5b5 *src, uint count, draw_op_t op, uint alpha) -> void {
+    const __m256i channel = _mm256_set1_epi16(0x1f);
+    const __m256i divide = _mm256_set1_epi16(2115);
+    const __m256i a = _mm256_set1_epi16(alpha);
+    const __m256i ia = _mm256_set1_epi16(31 - alpha);
+    uint i = 0;
+    for (; i + 16 <= count; i += 16) {
+      __m256i s = _mm256_loadu_si256((const __m256i*)(src + i));
+      __m256i d = _mm256_loadu_si256((const __m256i*)(dst + i));
+      __m256i transparent = _mm256_srai_epi16(s, 15);
+      __m256i result;
+      if (op == op_alpha) {
+        auto mix = [&](int shift) {
+          __m256i sc = _mm256_and_si256(_mm256_srli_epi16(s, shift), channel);
+          __m256i dc = _mm256_and_si256(_mm256_srli_epi16(d, shift), channel);
+          __m256i sum = _mm256_add_epi16(_mm256_mullo_epi16(sc, a), _mm256_mullo_epi16(dc, ia));
+          return _mm256_slli_epi16(_mm256_mulhi_epu16(sum, divide), shift);
+        };
+        result = _mm256_or_si256(_mm256_or_si256(mix(0), mix(5)), mix(10));
+      } else if (op == op_xor) {
+        result = _mm256_xor_si256(d, s);
+      } else {
+        result = s;
+      }
+      result = _mm256_or_si256(_mm256_and_si256(transparent, d), _mm256_andnot_si256(transparent, result));
+      _mm256_storeu_si256((__m256i*)(dst + i), result);
+    }
+    for (; i < count; i++) blend_pixel(dst[i], src[i], op, alpha);
+  }
+#elif defined(SIMD_SSE2)
+  static auto blend_row(r5g5b5 *dst, const r5g5b5 *src, uint count, draw_op_t op, uint alpha) -> void {
+    const __m128i channel = _mm_set1_epi16(0x1f);
+    const __m128i divide = _mm_set1_epi16(2115);
+    const __m128i a = _mm_set1_epi16(alpha);
+    const __m128i ia = _mm_set1_epi16(31 - alpha);
+    uint i = 0;
+    for (; i + 8 <= count; i += 8) {
+      __m128i s = _mm_loadu_si128((const __m128i*)(src + i));
+      __m128i d = _mm_loadu_si128((const __m128i*)(dst + i));
+      __m128i transparent = _mm_srai_epi16(s, 15);
+      __m128i result;
+      if (op == op_alpha) {
+        auto mix = [&](int shift) {
+          __m128i sc = _mm_and_si128(_mm_srli_epi16(s, shift), channel);
+          __m128i dc = _mm_and_si128(_mm_srli_epi16(d, shift), channel);
+          __m128i sum = _mm_add_epi16(_mm_mullo_epi16(sc, a), _mm_mullo_epi16(dc, ia));
+          return _mm_slli_epi16(_mm_mulhi_epu16(sum, divide), shift);
+        };
+        result = _mm_or_si128(_mm_or_si128(mix(0), mix(5)), mix(10));
+      } else if (op == op_xor) {
+        result = _mm_xor_si128(d, s);
+      } else {
+        result = s;
+      }
+      result = _mm_or_si128(_mm_and_si128(transparent, d), _mm_andnot_si128(transparent, result));
+      _mm_storeu_si128((__m128i*)(dst + i), result);
+    }
+    for (; i < count; i++) blend_pixel(dst[i], src[i], op, alpha);
+  }
+#else
+  static auto blend_row(r5g5b5 *dst, const r5g5b5 *src, uint count, draw_op_t op, uint alpha) -> void {
+    for (uint i = 0; i < count; i++) blend_pixel(dst[i], src[i], op, alpha);
+  }
+#endif
+
   b5g5r5 color = 0x7fff;
   auto get_color() -> b5g5r5 { return color; }
   auto set_color(b5g5r5 color_p) -> void { color = uclamp<15>(color_p); }
@@ -53,41 +142,10 @@ struct PostFrame {
     }
   }
 
-  auto inline draw(r5g5b5 *p) {
-    auto lumaLookup = ppuAccess.lightTable_lookup(/*io.displayBrightness*/ luma);
-    r5g5b5 real_color = lumaLookup[color];
-
-    switch (draw_op) {
-      case op_alpha: {
-        uint db = (*p & 0x001fu);
-        uint dg = (*p & 0x03e0u) >> 5u;
-        uint dr = (*p & 0x7c00u) >> 10u;
-        uint sb = (real_color & 0x001fu);
-        uint sg = (real_color & 0x03e0u) >> 5u;
-        uint sr = (real_color & 0x7c00u) >> 10u;
-
-        *p =
-          (((sb * alpha) + (db * (31u - alpha))) / 31u) |
-          (((sg * alpha) + (dg * (31u - alpha))) / 31u) << 5u |
-          (((sr * alpha) + (dr * (31u - alpha))) / 31u) << 10u;
-        break;
-      }
-
-      case op_xor:
-        *p ^= real_color;
-        break;
-
-      case op_solid:
-      default:
-        *p = real_color;
-        break;
-    }
-  }
-
   auto read_pixel(int x, int y) -> uint16 {
     // Scale the coordinates:
-    x = (x * x_scale * ppuFrame.width_mult) / 2;
-    y = ((y * y_scale + y_offset) * ppuFrame.height_mult) / 2;
+    x = frame_x(x);
+    y = frame_y(y);
     if (x >= 0 && y >= 0 && x < (int) width && y < (int) height) {
       return output[y * pitch + x];
     }
@@ -95,33 +153,51 @@ struct PostFrame {
     return 0xffff;
   }
 
-  auto pixel(int x, int y) -> void {
-    // Scale the coordinates:
-    x = (x * x_scale * ppuFrame.width_mult) / 2;
-    y = ((y * y_scale + y_offset) * ppuFrame.height_mult) / 2;
-    auto x_size = max((x_scale * ppuFrame.width_mult) / 2, 1);
-    auto y_size = max((y_scale * ppuFrame.height_mult) / 2, 1);
-    for (int sy = y; sy < y + y_size; sy++) {
-      for (int sx = x; sx < x + x_size; sx++) {
-        if (sx >= 0 && sy >= 0 && sx < (int) width && sy < (int) height) {
-          draw(&output[sy * pitch + sx]);
-        }
-      }
+  // frame coordinates of the first pixel covering x or y, and how many pixels one coordinate covers:
+  auto frame_x(int x) const -> int { return (x * x_scale * ppuFrame.width_mult) / 2; }
+  auto frame_y(int y) const -> int { return ((y * y_scale + y_offset) * ppuFrame.height_mult) / 2; }
+  auto x_size() const -> int { return max((x_scale * ppuFrame.width_mult) / 2, 1); }
+  auto y_size() const -> int { return max((y_scale * ppuFrame.height_mult) / 2, 1); }
+
+  // one row of scaled source pixels, reused across calls:
+  vector<r5g5b5> rowBuffer;
+
+  // clips the frame rectangle covering w*h pixels at lx,ty; returns false if nothing is visible:
+  auto clip(int lx, int ty, int w, int h, int &x0, int &y0, int &x1, int &y1) const -> bool {
+    if (w <= 0 || h <= 0) return false;
+    x0 = frame_x(lx), x1 = frame_x(lx + w - 1) + x_size();
+    y0 = frame_y(ty), y1 = frame_y(ty + h - 1) + y_size();
+    x0 = max(x0, 0), x1 = min(x1, (int)width);
+    y0 = max(y0, 0), y1 = min(y1, (int)height);
+    return x0 < x1 && y0 < y1;
+  }
+
+  // draws the current color over w*h pixels at lx,ty in one pass per frame row:
+  auto span(int lx, int ty, int w, int h) -> void {
+    int x0, y0, x1, y1;
+    if (!clip(lx, ty, w, h, x0, y0, x1, y1)) return;
+
+    r5g5b5 real_color = ppuAccess.lightTable_lookup(luma)[color];
+    uint count = x1 - x0;
+    rowBuffer.reallocate(count);
+    for (uint i : range(count)) rowBuffer[i] = real_color;
+    for (int y = y0; y < y1; y++) {
+      blend_row(&output[y * pitch + x0], rowBuffer.data(), count, draw_op, alpha);
     }
   }
 
+  auto pixel(int x, int y) -> void {
+    span(x, y, 1, 1);
+  }
+
   // draw a horizontal line from x=lx to lx+w on y=ty:
   auto hline(int lx, int ty, int w) -> void {
-    for (int x = lx; x < lx + w; ++x) {
-      pixel(x, ty);
-    }
+    span(lx, ty, w, 1);
   }
 
   // draw a vertical line from y=ty to ty+h on x=lx:
   auto vline(int lx, int ty, int h) -> void {
-    for (int y = ty; y < ty + h; ++y) {
-      pixel(lx, y);
-    }
+    span(lx, ty, 1, h);
   }
 
   // draw a rectangle with zero overdraw (important for op_xor and op_alpha draw ops):
@@ -134,9 +210,52 @@ struct PostFrame {
 
   // fill a rectangle with zero overdraw (important for op_xor and op_alpha draw ops):
   auto fill(int lx, int ty, int w, int h) -> void {
-    for (int y = ty; y < ty+h; y++)
-      for (int x = lx; x < lx+w; x++)
-        pixel(x, y);
+    span(lx, ty, w, h);
+  }
+
+  // draw a w*h bitmap of 15-bit colors at lx,ty with the current draw_op, luma and alpha; colors with bit 15 set
+  // (e.g. 0xffff) are transparent. Each bitmap row is scaled once and blended into every frame row it covers:
+  auto blit(int lx, int ty, int w, int h, const CScriptArray *pixels) -> void {
+    if (pixels == nullptr) {
+      asGetActiveContext()->SetException("pixels array cannot be null", true);
+      return;
+    }
+    if (pixels->GetElementTypeId() != asTYPEID_UINT16) {
+      asGetActiveContext()->SetException("pixels array must be uint16[]", true);
+      return;
+    }
+    if (w < 0 || h < 0 || pixels->GetSize() < (uint64)w * h) {
+      asGetActiveContext()->SetException("pixels array must have at least w*h elements", true);
+      return;
+    }
+
+    int x0, y0, x1, y1;
+    if (!clip(lx, ty, w, h, x0, y0, x1, y1)) return;
+
+    auto source = static_cast<const r5g5b5 *>(pixels->At(0));
+    auto lumaLookup = ppuAccess.lightTable_lookup(luma);
+    uint count = x1 - x0;
+    rowBuffer.reallocate(count);
+
+    // bitmap column covering each frame column:
+    int first = frame_x(lx);
+    int scale = x_scale * ppuFrame.width_mult;
+    auto column = [&](int fx) { return min(((fx - first) * 2) / scale, w - 1); };
+
+    int sy = 0, built = -1;
+    for (int y = y0; y < y1; y++) {
+      // advance to the last bitmap row starting at or above this frame row:
+      while (sy + 1 < h && frame_y(ty + sy + 1) <= y) sy++;
+      if (sy != built) {
+        auto line = source + sy * w;
+        for (uint i : range(count)) {
+          r5g5b5 c = line[column(x0 + i)];
+          rowBuffer[i] = c & 0x8000u ? c : lumaLookup[c];
+        }
+        built = sy;
+      }
+      blend_row(&output[y * pitch + x0], rowBuffer.data(), count, draw_op, alpha);
+    }
   }
 
   auto draw_glyph_8(int x, int y, int glyph) -> void {
@@ -326,6 +445,7 @@ auto RegisterPPUFrame(asIScriptEngine *e) -> void {
   r = e->RegisterObjectMethod("Frame", "void vline(int lx, int ty, int h)", asMETHOD(PostFrame, vline), asCALL_THISCALL); assert(r >= 0);
   r = e->RegisterObjectMethod("Frame", "void rect(int x, int y, int w, int h)", asMETHOD(PostFrame, rect), asCALL_THISCALL); assert(r >= 0);
   r = e->RegisterObjectMethod("Frame", "void fill(int x, int y, int w, int h)", asMETHOD(PostFrame, fill), asCALL_THISCALL); assert(r >= 0);
+  r = e->RegisterObjectMethod("Frame", "void blit(int x, int y, int w, int h, const array<uint16> &in pixels)", asMETHOD(PostFrame, blit), asCALL_THISCALL); assert(r >= 0);
 
   // text drawing function:
   r = e->RegisterObjectMethod("Frame", "int text(int x, int y, const string &in text)", asMETHOD(PostFrame, text), asCALL_THISCALL); assert(r >= 0);
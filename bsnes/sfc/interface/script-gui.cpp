@@ -388,7 +388,7 @@ auto RegisterGUI(asIScriptEngine *e) -> void {
   r = e->RegisterObjectBehaviour("Window", asBEHAVE_FACTORY, "Window@ f()", asFUNCTION( +([]{
     auto window = new hiro::Window;
     // keep a reference for later destruction when unloading script:
-    ::SuperFamicom::script.windows.append(*window);
+    trackWindow(*window);
     return window;
   }) ), asCALL_CDECL); assert(r >= 0);
   EXPOSE_SHARED_PTR(Window, hiro::Window, hiro::mWindow);
@@ -396,7 +396,7 @@ auto RegisterGUI(asIScriptEngine *e) -> void {
   r = e->RegisterObjectBehaviour("Window", asBEHAVE_FACTORY, "Window@ f(float rx, float ry, bool relative)", asFUNCTION(+([](float x, float y, bool relative) {
     auto window = new hiro::Window;
     // keep a reference for later destruction when unloading script:
-    ::SuperFamicom::script.windows.append(*window);
+    trackWindow(*window);
     if (relative) {
       window->setPosition(platform->presentationWindow(), hiro::Position{x, y});
     } else {
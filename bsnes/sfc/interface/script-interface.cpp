@@ -8,6 +8,12 @@
   #include <netinet/in.h>
   #include <netinet/tcp.h>
   #include <netdb.h>
+  #include <sys/uio.h>
+  #include <poll.h>
+  #if defined(PLATFORM_LINUX)
+    #include <sys/epoll.h>
+    #include <sys/eventfd.h>
+  #endif
   #define SEND_BUF_CAST(t) ((const void *)(t))
   #define RECV_BUF_CAST(t) ((void *)(t))
 
@@ -267,6 +273,212 @@ namespace ScriptInterface {
     }
   } profiler;
 
+  // measures every host-to-script entry (callbacks, interceptors, pre_frame, etc.) per script function:
+  struct CallProfiler {
+    enum : uint { Capacity = 256, Slots = 512 };
+
+    struct entry_t {
+      asIScriptFunction *func;
+      string name;
+      // name as a CSV field, with its quotes doubled:
+      string field;
+
+      uint64 calls;
+      uint64 totalNanoseconds;
+      uint64 minNanoseconds;
+      uint64 maxNanoseconds;
+
+      // accumulating for the current frame:
+      uint64 frameCalls;
+      uint64 frameNanoseconds;
+      // completed last frame:
+      uint64 lastFrameCalls;
+      uint64 lastFrameNanoseconds;
+      double lastFrameShare;
+
+      auto get_name() -> string { return name; }
+      auto get_average_ns() -> uint64 { return calls ? totalNanoseconds / calls : 0; }
+    };
+
+    bool enabled = false;
+
+    entry_t entries[Capacity];
+    uint count = 0;
+    uint untracked = 0;
+    // open-addressed table of entry index + 1 keyed by function pointer; 0 is an empty slot:
+    uint16 slots[Slots] = {};
+
+    uint64 frameNumber = 0;
+    uint64 frameStart = 0;
+    uint64 lastFrameNanoseconds = 0;
+
+    // time spent in outermost entries only, so that nested calls are not counted twice:
+    uint depth = 0;
+    uint64 scriptNanoseconds = 0;
+
+    // only touched by the emulation thread:
+    string logChunk;
+    uint logChunkFrames = 0;
+    // handed off to the writer thread once per second:
+    string logPending;
+    std::mutex logMutex;
+    std::condition_variable logWake;
+    nall::thread logThread;
+    std::atomic<bool> logging{false};
+    file_buffer logFile;
+
+    ~CallProfiler() {
+      stopLog();
+    }
+
+    auto entry(asIScriptFunction *func) -> entry_t* {
+      uint slot = (uint(uintptr(func) >> 4) * 2654435761u) & (Slots - 1);
+      while (slots[slot]) {
+        auto e = &entries[slots[slot] - 1];
+        if (e->func == func) return e;
+        slot = (slot + 1) & (Slots - 1);
+      }
+
+      if (count >= Capacity) return nullptr;
+
+      auto e = &entries[count++];
+      *e = {};
+      e->func = func;
+      e->name = func ? string(func->GetDeclaration(true, true)) : string("<unknown>");
+      e->field = {"\"", string(e->name).replace("\"", "\"\""), "\""};
+      e->minNanoseconds = ~0ull;
+      slots[slot] = count;
+      return e;
+    }
+
+    auto execute(asIScriptContext *ctx) -> void {
+      auto e = entry(ctx->GetFunction());
+
+      auto start = chrono::nanosecond();
+      depth++;
+      ctx->Execute();
+      depth--;
+      auto elapsed = chrono::nanosecond() - start;
+      if (!depth) scriptNanoseconds += elapsed;
+
+      if (!e) {
+        untracked++;
+        return;
+      }
+      e->calls++;
+      e->totalNanoseconds += elapsed;
+      if (elapsed < e->minNanoseconds) e->minNanoseconds = elapsed;
+      if (elapsed > e->maxNanoseconds) e->maxNanoseconds = elapsed;
+      e->frameCalls++;
+      e->frameNanoseconds += elapsed;
+    }
+
+    // called once at the start of every frame:
+    auto frame() -> void {
+      auto now = chrono::nanosecond();
+      lastFrameNanoseconds = frameStart ? now - frameStart : 0;
+      frameStart = now;
+      frameNumber++;
+
+      for (uint i : range(count)) {
+        auto& e = entries[i];
+        e.lastFrameCalls = e.frameCalls;
+        e.lastFrameNanoseconds = e.frameNanoseconds;
+        e.lastFrameShare = lastFrameNanoseconds ? double(e.frameNanoseconds) / lastFrameNanoseconds : 0.0;
+
+        if (logging && e.frameCalls) {
+          logChunk.append(frameNumber, ",", lastFrameNanoseconds, ",", e.field, ",", e.frameCalls, ",", e.frameNanoseconds, "\n");
+        }
+
+        e.frameCalls = 0;
+        e.frameNanoseconds = 0;
+      }
+
+      if (logging && ++logChunkFrames >= 60) {
+        {
+          std::lock_guard<std::mutex> lock(logMutex);
+          logPending.append(logChunk);
+        }
+        logWake.notify_one();
+        logChunk.reset();
+        logChunkFrames = 0;
+      }
+    }
+
+    auto reset() -> void {
+      count = 0;
+      untracked = 0;
+      memory::fill<uint16>(slots, Slots);
+    }
+
+    // sleeps until a chunk is handed off or logging stops:
+    auto writerThread(uintptr) -> void {
+      std::unique_lock<std::mutex> lock(logMutex);
+      while (true) {
+        logWake.wait(lock, [&] { return logPending || !logging; });
+        bool stop = !logging;
+        string chunk = move(logPending);
+        logPending.reset();
+
+        lock.unlock();
+        if (chunk) logFile.writes(chunk);
+        if (stop) break;
+        lock.lock();
+      }
+    }
+
+    // returns false if the file could not be opened:
+    auto startLog(const string &path) -> bool {
+      stopLog();
+
+      if (!logFile.open(path, file_buffer::mode::write)) return false;
+      logFile.truncate(0);
+      logFile.writes({"frame,frame_ns,function,calls,ns\n"});
+
+      logChunk.reset();
+      logChunkFrames = 0;
+      logging = true;
+      logThread = nall::thread::create({&CallProfiler::writerThread, this});
+      return true;
+    }
+
+    auto stopLog() -> void {
+      if (!logging) return;
+
+      // flush what the emulation thread has buffered:
+      {
+        std::lock_guard<std::mutex> lock(logMutex);
+        logPending.append(logChunk);
+        logging = false;
+      }
+      logWake.notify_one();
+      logChunk.reset();
+
+      logThread.join();
+      logFile.close();
+    }
+
+    auto report() -> string {
+      string text;
+      text.append("     calls    total us    avg us    min us    max us  frame%  function\n");
+      for (uint i : range(count)) {
+        auto& e = entries[i];
+        if (!e.calls) continue;
+        text.append(
+          pad(e.calls, 10), "  ",
+          pad(e.totalNanoseconds / 1000, 10), "  ",
+          pad(e.get_average_ns() / 1000, 8), "  ",
+          pad(e.minNanoseconds / 1000, 8), "  ",
+          pad(e.maxNanoseconds / 1000, 8), "  ",
+          pad(uint(e.lastFrameShare * 100.0 + 0.5), 6), "  ",
+          e.name, "\n"
+        );
+      }
+      if (untracked) text.append("(", untracked, " calls to untracked functions)\n");
+      return text;
+    }
+  } callProfiler;
+
   static auto message(const string *msg) -> void {
     platform->scriptMessage(*msg);
   }
@@ -403,10 +615,118 @@ namespace ScriptInterface {
   }
 
   auto executeScript(asIScriptContext *ctx) -> void {
-    ctx->Execute();
+    if (callProfiler.enabled) {
+      callProfiler.execute(ctx);
+    } else {
+      ctx->Execute();
+    }
     profiler.resetLocation();
   }
 
+  // contexts kept prepared per callback function so that hot hooks (pc, write, dma interceptors) alternating with each
+  // other do not defeat AngelScript's fast path for re-preparing the same function:
+  struct ContextPool {
+    enum : uint { Slots = 64 };
+
+    struct slot_t {
+      asIScriptFunction *func = nullptr;
+      asIScriptContext  *ctx = nullptr;
+    } slots[Slots];
+
+    // contexts for nested calls whose slot context is already executing:
+    vector<asIScriptContext *> spares;
+
+    static auto hash(asIScriptFunction *func) -> uint {
+      return (uint(uintptr(func) >> 4) * 2654435761u) >> 26;
+    }
+
+    auto create() -> asIScriptContext* {
+      auto ctx = ::SuperFamicom::script.engine->CreateContext();
+      ctx->SetExceptionCallback(asMETHOD(ScriptInterface::ExceptionHandler, exceptionCallback), &exceptionHandler, asCALL_THISCALL);
+#if defined(AS_PROFILER_ENABLE)
+      ctx->SetLineCallback(asMETHOD(ScriptInterface::Profiler, lineCallback), &profiler, asCALL_THISCALL);
+#endif
+      return ctx;
+    }
+
+    auto acquire(asIScriptFunction *func) -> asIScriptContext* {
+      auto& slot = slots[hash(func)];
+      if (!slot.ctx) slot.ctx = create();
+
+      if (slot.ctx->GetState() != asEXECUTION_ACTIVE) {
+        // Prepare() is cheap when the context last ran the same function:
+        slot.func = func;
+        slot.ctx->Prepare(func);
+        return slot.ctx;
+      }
+
+      // nested call; slot context is busy further up the stack:
+      auto ctx = spares ? spares.takeLast() : create();
+      ctx->Prepare(func);
+      return ctx;
+    }
+
+    auto release(asIScriptContext *ctx) -> void {
+      auto& slot = slots[hash(ctx->GetFunction())];
+      if (slot.ctx == ctx) return;
+      ctx->Unprepare();
+      spares.append(ctx);
+    }
+
+    auto reset() -> void {
+      for (auto& slot : slots) {
+        if (slot.ctx) slot.ctx->Release();
+        slot = {};
+      }
+      for (auto ctx : spares) ctx->Release();
+      spares.reset();
+    }
+  } contextPool;
+
+  // runs a callback on its pooled context:
+  template<typename F>
+  auto executeCallback(asIScriptFunction *cb, const F &setArgs) -> void {
+    if (::SuperFamicom::script.speculative && skipSpeculative(cb)) return;
+    auto ctx = contextPool.acquire(cb);
+    setArgs(ctx);
+    executeScript(ctx);
+    contextPool.release(ctx);
+  }
+
+  auto profileFrame() -> void {
+    if (!callProfiler.enabled) return;
+    callProfiler.frame();
+  }
+
+  struct ProfilerAccess {
+    static auto get_enabled() -> bool { return callProfiler.enabled; }
+    static auto set_enabled(bool enabled) -> void {
+      if (enabled && !callProfiler.enabled) callProfiler.frameStart = 0;
+      callProfiler.enabled = enabled;
+    }
+    static auto reset() -> void { callProfiler.reset(); }
+    static auto get_count() -> uint { return callProfiler.count; }
+    static auto get_entries(uint i) -> CallProfiler::entry_t* {
+      if (i >= callProfiler.count) {
+        asGetActiveContext()->SetException("index out of range", true);
+        return nullptr;
+      }
+      return &callProfiler.entries[i];
+    }
+    static auto get_frame_ns() -> uint64 { return callProfiler.lastFrameNanoseconds; }
+    static auto report() -> void { platform->scriptMessage(callProfiler.report()); }
+    static auto start_log(const string *path) -> bool { return callProfiler.startLog(*path); }
+    static auto stop_log() -> void { callProfiler.stopLog(); }
+  };
+
+  auto profileEnable(bool enable) -> void {
+    ProfilerAccess::set_enabled(enable);
+  }
+
+  auto profileNanoseconds() -> uint64 {
+    return callProfiler.scriptNanoseconds;
+  }
+
   struct Callback {
     asIScriptFunction *cb;
 
@@ -422,15 +742,17 @@ namespace ScriptInterface {
     }
 
     auto operator()() -> void {
-      auto ctx = ::SuperFamicom::script.context;
-      ctx->Prepare(cb);
-      executeScript(ctx);
+      executeCallback(cb, [](asIScriptContext *ctx) {});
     }
   };
 
+  #include "script-cache.cpp"
+  #include "script-module.cpp"
+  #include "script-runahead.cpp"
   #include "script-bus.cpp"
   #include "script-ppu.cpp"
   #include "script-frame.cpp"
+  #include "script-overlay.cpp"
   #include "script-extra.cpp"
   #include "script-net.cpp"
   #include "script-gui.cpp"
@@ -443,8 +765,8 @@ auto Interface::paletteUpdated(uint32_t *palette, uint depth) -> void {
   ScriptInterface::emulatorPalette = palette;
   ScriptInterface::emulatorDepth = depth;
 
-  if (script.funcs.palette_updated) {
-    script.context->Prepare(script.funcs.palette_updated);
+  for (auto func : script.funcs.palette_updated) {
+    script.context->Prepare(func);
     ScriptInterface::executeScript(script.context);
   }
 }
@@ -488,12 +810,40 @@ auto Interface::registerScriptDefs() -> void {
     r = script.engine->RegisterGlobalFunction("uint64 get_timestamp() property", asFUNCTIONPR(chrono::timestamp, (), uint64_t), asCALL_CDECL); assert(r >= 0);
   }
 
+  // profiler namespace to measure time spent in script callbacks:
+  {
+    r = script.engine->SetDefaultNamespace("profiler"); assert(r >= 0);
+
+    r = script.engine->RegisterObjectType    ("Entry", sizeof(ScriptInterface::CallProfiler::entry_t), asOBJ_REF | asOBJ_NOCOUNT); assert(r >= 0);
+    r = script.engine->RegisterObjectMethod  ("Entry", "string get_name() property", asMETHOD(ScriptInterface::CallProfiler::entry_t, get_name), asCALL_THISCALL); assert(r >= 0);
+    r = script.engine->RegisterObjectProperty("Entry", "uint64 calls", asOFFSET(ScriptInterface::CallProfiler::entry_t, calls)); assert(r >= 0);
+    r = script.engine->RegisterObjectProperty("Entry", "uint64 total_ns", asOFFSET(ScriptInterface::CallProfiler::entry_t, totalNanoseconds)); assert(r >= 0);
+    r = script.engine->RegisterObjectProperty("Entry", "uint64 min_ns", asOFFSET(ScriptInterface::CallProfiler::entry_t, minNanoseconds)); assert(r >= 0);
+    r = script.engine->RegisterObjectProperty("Entry", "uint64 max_ns", asOFFSET(ScriptInterface::CallProfiler::entry_t, maxNanoseconds)); assert(r >= 0);
+    r = script.engine->RegisterObjectMethod  ("Entry", "uint64 get_average_ns() property", asMETHOD(ScriptInterface::CallProfiler::entry_t, get_average_ns), asCALL_THISCALL); assert(r >= 0);
+    r = script.engine->RegisterObjectProperty("Entry", "uint64 frame_calls", asOFFSET(ScriptInterface::CallProfiler::entry_t, lastFrameCalls)); assert(r >= 0);
+    r = script.engine->RegisterObjectProperty("Entry", "uint64 frame_ns", asOFFSET(ScriptInterface::CallProfiler::entry_t, lastFrameNanoseconds)); assert(r >= 0);
+    r = script.engine->RegisterObjectProperty("Entry", "double frame_share", asOFFSET(ScriptInterface::CallProfiler::entry_t, lastFrameShare)); assert(r >= 0);
+
+    r = script.engine->RegisterGlobalFunction("bool get_enabled() property", asFUNCTION(ScriptInterface::ProfilerAccess::get_enabled), asCALL_CDECL); assert(r >= 0);
+    r = script.engine->RegisterGlobalFunction("void set_enabled(bool enabled) property", asFUNCTION(ScriptInterface::ProfilerAccess::set_enabled), asCALL_CDECL); assert(r >= 0);
+    r = script.engine->RegisterGlobalFunction("void reset()", asFUNCTION(ScriptInterface::ProfilerAccess::reset), asCALL_CDECL); assert(r >= 0);
+    r = script.engine->RegisterGlobalFunction("uint get_count() property", asFUNCTION(ScriptInterface::ProfilerAccess::get_count), asCALL_CDECL); assert(r >= 0);
+    r = script.engine->RegisterGlobalFunction("Entry @get_entries(uint i) property", asFUNCTION(ScriptInterface::ProfilerAccess::get_entries), asCALL_CDECL); assert(r >= 0);
+    r = script.engine->RegisterGlobalFunction("uint64 get_frame_ns() property", asFUNCTION(ScriptInterface::ProfilerAccess::get_frame_ns), asCALL_CDECL); assert(r >= 0);
+    r = script.engine->RegisterGlobalFunction("void report()", asFUNCTION(ScriptInterface::ProfilerAccess::report), asCALL_CDECL); assert(r >= 0);
+    r = script.engine->RegisterGlobalFunction("bool start_log(const string &in path)", asFUNCTION(ScriptInterface::ProfilerAccess::start_log), asCALL_CDECL); assert(r >= 0);
+    r = script.engine->RegisterGlobalFunction("void stop_log()", asFUNCTION(ScriptInterface::ProfilerAccess::stop_log), asCALL_CDECL); assert(r >= 0);
+  }
+
+  ScriptInterface::RegisterRunAhead(script.engine);
   ScriptInterface::RegisterBus(script.engine);
 
   {
     // Order here is important as RegisterPPU sets namespace to 'ppu' and the following functions expect that.
     ScriptInterface::RegisterPPU(script.engine);
     ScriptInterface::RegisterPPUFrame(script.engine);
+    ScriptInterface::RegisterPPUOverlay(script.engine);
     ScriptInterface::RegisterPPUExtra(script.engine);
   }
 
@@ -506,6 +856,9 @@ auto Interface::registerScriptDefs() -> void {
 
   r = script.engine->SetDefaultNamespace(defaultNamespace); assert(r >= 0);
 
+  // the bytecode cache is only valid for exactly this set of registrations:
+  ScriptInterface::bytecodeCache.hashAPI(script.engine);
+
   // create context:
   script.context = script.engine->CreateContext();
 
@@ -513,85 +866,73 @@ auto Interface::registerScriptDefs() -> void {
 }
 
 auto Interface::loadScript(string location) -> void {
-  int r;
-
   if (!inode::exists(location)) return;
 
-  if (script.modules) {
+  // reloading the same location keeps the modules whose sources are unchanged running:
+  if (script.location && script.location != location) {
     unloadScript();
   }
+  bool reload = (bool)script.location;
+  script.location = location;
+
+  auto sources = ScriptInterface::gatherModules(script.engine, location);
+
+  // unload modules which were removed or changed since they were loaded:
+  for (uint i = script.modules.size(); i > 0; i--) {
+    auto& module = script.modules[i - 1];
+    auto source = sources.find([&](auto& source) { return source.name == module.name; });
+    if (source && sources[*source].key == module.key) continue;
+    ScriptInterface::unloadModule(module);
+    script.modules.remove(i - 1);
+  }
 
-  // create a main module:
-  script.main_module = script.engine->GetModule("main", asGM_ALWAYS_CREATE);
-
-  if (directory::exists(location)) {
-    // add all *.as files in root directory to main module:
-    for (auto scriptLocation : directory::files(location, "*.as")) {
-      string path = scriptLocation;
-      path.prepend(location);
-
-      auto filename = Location::file(path);
-      //platform->scriptMessage({"Loading ", path});
-
-      // load script from file:
-      string scriptSource = string::read(path);
-      if (!scriptSource) {
-        platform->scriptMessage({"WARN empty file at ", path});
-      }
-
-      // add script section into module:
-      r = script.main_module->AddScriptSection(filename, scriptSource.begin(), scriptSource.length());
-      if (r < 0) {
-        platform->scriptMessage({"Loading ", filename, " failed"});
-        return;
-      }
+  // build new and changed modules; a module that fails to compile is left out without affecting the others:
+  vector<Script::Module> modules;
+  vector<Script::Module> built;
+  for (auto& source : sources) {
+    if (auto loaded = script.modules.find([&](auto& module) { return module.name == source.name; })) {
+      modules.append(script.modules[*loaded]);
+      continue;
     }
 
-    // TODO: more modules from folders
-  } else {
-    // load script from single specified file:
-    string scriptSource = string::read(location);
-
-    // add script into main module:
-    r = script.main_module->AddScriptSection(Location::file(location), scriptSource.begin(), scriptSource.length());
-    assert(r >= 0);
+    Script::Module module;
+    module.name = source.name;
+    module.key = source.key;
+    module.module = ScriptInterface::buildModule(script.engine, source);
+    if (!module.module) continue;
+    ScriptInterface::bindModule(module);
+    modules.append(module);
+    built.append(module);
   }
+  script.modules = modules;
 
-  // compile module:
-  r = script.main_module->Build();
-  assert(r >= 0);
-
-  // track main module:
-  script.modules.append(script.main_module);
+  ScriptInterface::bindImports();
+  ScriptInterface::bindCallbacks();
 
-  // bind to functions in the main module:
-  script.funcs.init = script.main_module->GetFunctionByDecl("void init()");
-  script.funcs.unload = script.main_module->GetFunctionByDecl("void unload()");
-  script.funcs.post_power = script.main_module->GetFunctionByDecl("void post_power(bool reset)");
-  script.funcs.cartridge_loaded = script.main_module->GetFunctionByDecl("void cartridge_loaded()");
-  script.funcs.cartridge_unloaded = script.main_module->GetFunctionByDecl("void cartridge_unloaded()");
-  script.funcs.pre_nmi = script.main_module->GetFunctionByDecl("void pre_nmi()");
-  script.funcs.pre_frame = script.main_module->GetFunctionByDecl("void pre_frame()");
-  script.funcs.post_frame = script.main_module->GetFunctionByDecl("void post_frame()");
-  script.funcs.palette_updated = script.main_module->GetFunctionByDecl("void palette_updated()");
+  if (reload && sources.size() > 1) {
+    platform->scriptMessage({"Reloaded ", built.size(), " of ", sources.size(), " script modules"});
+  }
 
 #if defined(AS_PROFILER_ENABLE)
-  ScriptInterface::profiler.enable(script.context);
+  if (!reload) ScriptInterface::profiler.enable(script.context);
 #endif
 
-  if (script.funcs.init) {
-    script.context->Prepare(script.funcs.init);
-    ScriptInterface::executeScript(script.context);
-  }
-  if (loaded()) {
-    if (script.funcs.cartridge_loaded) {
-      script.context->Prepare(script.funcs.cartridge_loaded);
+  // only newly built modules are initialized:
+  for (auto& module : built) {
+    if (auto func = module.funcs.init) {
+      script.context->Prepare(func);
       ScriptInterface::executeScript(script.context);
     }
-    if (script.funcs.post_power) {
-      script.context->Prepare(script.funcs.post_power);
-      script.context->SetArgByte(0, false); // reset = false
-      ScriptInterface::executeScript(script.context);
+    if (loaded()) {
+      if (auto func = module.funcs.cartridge_loaded) {
+        script.context->Prepare(func);
+        ScriptInterface::executeScript(script.context);
+      }
+      if (auto func = module.funcs.post_power) {
+        script.context->Prepare(func);
+        script.context->SetArgByte(0, false); // reset = false
+        ScriptInterface::executeScript(script.context);
+      }
     }
   }
 }
@@ -599,22 +940,19 @@ auto Interface::loadScript(string location) -> void {
 auto Interface::unloadScript() -> void {
   // free any references to script callbacks:
   ::SuperFamicom::bus.reset_interceptors();
+  ScriptInterface::resetWriteEvents();
+  ScriptInterface::resetRasterEvents();
+  ScriptInterface::Net::reactor.reset();
   ::SuperFamicom::cpu.reset_dma_interceptor();
   ::SuperFamicom::cpu.reset_pc_callbacks();
+  ScriptInterface::hooks.reset();
 
   // Close any GUI windows:
-  for (auto window : script.windows) {
-    if (!window) continue;
-    window->setVisible(false);
-    window->setDismissable(true);
-    window->destruct();
-    window.reset();
-  }
-  script.windows.reset();
+  ScriptInterface::closeWindows();
 
-  // unload script:
-  if (script.funcs.unload) {
-    script.context->Prepare(script.funcs.unload);
+  // unload scripts:
+  for (auto func : script.funcs.unload) {
+    script.context->Prepare(func);
     ScriptInterface::executeScript(script.context);
   }
 
@@ -624,22 +962,20 @@ auto Interface::unloadScript() -> void {
   ScriptInterface::profiler.disable(script.context);
 #endif
 
+  // profiled functions are about to be discarded:
+  ScriptInterface::callProfiler.stopLog();
+  ScriptInterface::callProfiler.reset();
+
+  // release pooled contexts which hold references to script functions:
+  ScriptInterface::contextPool.reset();
+
   // discard all loaded modules:
-  for (auto module : script.modules) {
-    module->Discard();
+  for (auto& module : script.modules) {
+    module.module->Discard();
   }
   script.modules.reset();
-  script.main_module = nullptr;
-
-  script.funcs.init = nullptr;
-  script.funcs.unload = nullptr;
-  script.funcs.post_power = nullptr;
-  script.funcs.cartridge_loaded = nullptr;
-  script.funcs.cartridge_unloaded = nullptr;
-  script.funcs.pre_nmi = nullptr;
-  script.funcs.pre_frame = nullptr;
-  script.funcs.post_frame = nullptr;
-  script.funcs.palette_updated = nullptr;
+  script.location = {};
+  script.funcs = {};
 
   // reset extra-tile data:
   ScriptInterface::extraLayer.reset();
@@ -0,0 +1,241 @@
+// scripts are loaded as one module for the *.as files in the script folder and one module for each of its subfolders.
+// Modules only share the entities they declare `shared` and the functions they `import`, so a module can be rebuilt
+// without touching the others as long as its sources are unchanged.
+
+using ScriptModule = ::SuperFamicom::Script::Module;
+
+static auto moduleOf(asIScriptFunction *func) -> asIScriptModule* {
+  if (!func) return nullptr;
+  if (auto delegate = func->GetDelegateFunction()) func = delegate;
+  return func->GetModule();
+}
+
+// module whose code is currently running, e.g. the one calling a registered function:
+static auto activeModule() -> asIScriptModule* {
+  auto ctx = asGetActiveContext();
+  return ctx ? moduleOf(ctx->GetFunction()) : nullptr;
+}
+
+// tracks which module registered each hook (interceptors, windows, ...) so that the hooks of a single module can be
+// removed when it is reloaded. A hook is keyed by what it occupies, e.g. a bus interceptor id or a pc address, so that
+// a later registration of the same key takes over ownership:
+struct Hooks {
+  struct hook_t {
+    asIScriptModule *module;
+    string key;
+    function<void ()> release;
+  };
+  vector<hook_t> hooks;
+
+  auto track(asIScriptModule *module, const string &key, const function<void ()> &release) -> void {
+    untrack(key);
+    hooks.append({module, key, release});
+  }
+
+  auto track(asIScriptFunction *cb, const string &key, const function<void ()> &release) -> void {
+    track(moduleOf(cb), key, release);
+  }
+
+  auto untrack(const string &key) -> void {
+    for (uint i = 0; i < hooks.size();) {
+      if (hooks[i].key == key) hooks.remove(i);
+      else i++;
+    }
+  }
+
+  // removes every hook registered by the module:
+  auto release(asIScriptModule *module) -> void {
+    for (uint i = 0; i < hooks.size();) {
+      if (hooks[i].module != module) { i++; continue; }
+      auto release = hooks[i].release;
+      hooks.remove(i);
+      if (release) release();
+    }
+  }
+
+  // forgets all hooks; used when everything they refer to is reset at once:
+  auto reset() -> void {
+    hooks.reset();
+  }
+} hooks;
+
+// GUI windows belong to the module that created them:
+static auto trackWindow(hiro::Window window) -> void {
+  ::SuperFamicom::script.windows.append({activeModule(), window});
+}
+
+static auto closeWindows(asIScriptModule *module = nullptr) -> void {
+  auto& windows = ::SuperFamicom::script.windows;
+  for (uint i = 0; i < windows.size();) {
+    if (module && windows[i].module != module) { i++; continue; }
+    if (auto window = windows[i].window) {
+      window->setVisible(false);
+      window->setDismissable(true);
+      window->destruct();
+    }
+    windows.remove(i);
+  }
+}
+
+struct ModuleSource {
+  string name;
+  string location;  // file or folder the sections were read from; identifies the bytecode cache file
+  vector<string> names;
+  vector<string> sources;
+  vector<string> warnings;
+
+  string key;
+  vector<uint8_t> bytecode;  // cached bytecode matching key, if any
+};
+
+static auto readModuleSource(ModuleSource &source, const string &folder) -> void {
+  for (auto scriptLocation : directory::files(folder, "*.as")) {
+    string path = {folder, scriptLocation};
+
+    // load script from file:
+    string scriptSource = string::read(path);
+    if (!scriptSource) {
+      source.warnings.append({"WARN empty file at ", path});
+    }
+
+    source.names.append(source.name == "main" ? Location::file(path) : string{source.name, "/", Location::file(path)});
+    source.sources.append(scriptSource);
+  }
+}
+
+// reads the sources of every module and looks up their cached bytecode. Modules are independent of each other, so this
+// is spread across worker threads; building stays on the calling thread as an engine only builds one module at a time:
+static auto gatherModules(asIScriptEngine *engine, const string &location) -> vector<ModuleSource> {
+  vector<ModuleSource> modules;
+  vector<string> folders;
+
+  if (directory::exists(location)) {
+    // *.as files in root directory make up the main module:
+    modules.append({"main", location});
+    folders.append(location);
+    // and every subfolder containing *.as files is a module of its own:
+    for (auto folder : directory::folders(location)) {
+      string path = {location, folder};
+      if (!directory::files(path, "*.as")) continue;
+      modules.append({folder.trimRight("/", 1L), path});
+      folders.append(path);
+    }
+  } else {
+    // load script from single specified file:
+    ModuleSource source{"main", location};
+    source.names.append(Location::file(location));
+    source.sources.append(string::read(location));
+    modules.append(source);
+    folders.append("");
+  }
+
+  std::atomic<uint> next{0};
+  auto work = [&] {
+    for (uint i; (i = next++) < modules.size();) {
+      auto& source = modules[i];
+      if (folders[i]) readModuleSource(source, folders[i]);
+      source.key = bytecodeCache.key(engine, source.names, source.sources);
+      source.bytecode = bytecodeCache.read(source.location, source.key);
+    }
+  };
+
+  std::vector<std::thread> workers;
+  uint threads = min((uint)modules.size(), max(1u, std::thread::hardware_concurrency()));
+  for (uint n = 1; n < threads; n++) workers.emplace_back(work);
+  work();
+  for (auto& worker : workers) worker.join();
+
+  return modules;
+}
+
+// loads the module from its cached bytecode or compiles it; returns nullptr if it failed to compile:
+static auto buildModule(asIScriptEngine *engine, ModuleSource &source) -> asIScriptModule* {
+  for (auto& warning : source.warnings) platform->scriptMessage(warning);
+
+  auto module = engine->GetModule(source.name, asGM_ALWAYS_CREATE);
+  if (bytecodeCache.load(module, source.bytecode, source.key)) return module;
+
+  // a failed load may leave a partially restored module behind:
+  module = engine->GetModule(source.name, asGM_ALWAYS_CREATE);
+
+  for (uint i : range(source.names.size())) {
+    // add script section into module:
+    int r = module->AddScriptSection(source.names[i], source.sources[i].data(), source.sources[i].size());
+    if (r < 0) {
+      platform->scriptMessage({"Loading ", source.names[i], " failed"});
+      module->Discard();
+      return nullptr;
+    }
+  }
+
+  // compile module:
+  if (module->Build() < 0) {
+    platform->scriptMessage({"Module '", source.name, "' failed to compile"}, true);
+    module->Discard();
+    return nullptr;
+  }
+
+  bytecodeCache.save(module, source.location, source.key);
+  return module;
+}
+
+// bind to the optional functions defined by the module:
+static auto bindModule(ScriptModule &module) -> void {
+  auto m = module.module;
+  module.funcs.init = m->GetFunctionByDecl("void init()");
+  module.funcs.unload = m->GetFunctionByDecl("void unload()");
+  module.funcs.post_power = m->GetFunctionByDecl("void post_power(bool reset)");
+  module.funcs.cartridge_loaded = m->GetFunctionByDecl("void cartridge_loaded()");
+  module.funcs.cartridge_unloaded = m->GetFunctionByDecl("void cartridge_unloaded()");
+  module.funcs.pre_nmi = m->GetFunctionByDecl("void pre_nmi()");
+  module.funcs.pre_frame = m->GetFunctionByDecl("void pre_frame()");
+  module.funcs.post_frame = m->GetFunctionByDecl("void post_frame()");
+  module.funcs.palette_updated = m->GetFunctionByDecl("void palette_updated()");
+}
+
+// collects the callbacks of all loaded modules so that the emulator calls each of them in module order:
+static auto bindCallbacks() -> void {
+  auto& script = ::SuperFamicom::script;
+  script.funcs = {};
+  for (auto& module : script.modules) {
+    if (auto f = module.funcs.init) script.funcs.init.append(f);
+    if (auto f = module.funcs.unload) script.funcs.unload.append(f);
+    if (auto f = module.funcs.post_power) script.funcs.post_power.append(f);
+    if (auto f = module.funcs.cartridge_loaded) script.funcs.cartridge_loaded.append(f);
+    if (auto f = module.funcs.cartridge_unloaded) script.funcs.cartridge_unloaded.append(f);
+    if (auto f = module.funcs.pre_nmi) script.funcs.pre_nmi.append(f);
+    if (auto f = module.funcs.pre_frame) script.funcs.pre_frame.append(f);
+    if (auto f = module.funcs.post_frame) script.funcs.post_frame.append(f);
+    if (auto f = module.funcs.palette_updated) script.funcs.palette_updated.append(f);
+  }
+}
+
+// (re)binds the functions each module imports from the others:
+static auto bindImports() -> void {
+  for (auto& module : ::SuperFamicom::script.modules) {
+    auto m = module.module;
+    if (!m->GetImportedFunctionCount()) continue;
+    m->UnbindAllImportedFunctions();
+    if (m->BindAllImportedFunctions() < 0) {
+      platform->scriptMessage({"WARN module '", module.name, "' imports functions that no loaded module defines"}, true);
+    }
+  }
+}
+
+// removes everything the module registered with the emulator and runs its unload() function before discarding it:
+static auto unloadModule(ScriptModule &module) -> void {
+  hooks.release(module.module);
+  closeWindows(module.module);
+
+  if (auto func = module.funcs.unload) {
+    ::SuperFamicom::script.context->Prepare(func);
+    executeScript(::SuperFamicom::script.context);
+  }
+
+  // pooled contexts and profiler entries may refer to functions of the module:
+  contextPool.reset();
+  callProfiler.reset();
+
+  module.module->Discard();
+  module.module = nullptr;
+}
@@ -73,6 +73,27 @@ namespace Net {
     return s;
   }
 
+  // true if the last error only means that a non-blocking socket is not ready, which is then cleared:
+  static auto would_block() -> bool {
+#if !defined(PLATFORM_WINDOWS)
+    if (last_error != EWOULDBLOCK && last_error != EAGAIN) return false;
+#else
+    if (last_error != WSAEWOULDBLOCK) return false;
+#endif
+    last_error = 0;
+    return true;
+  }
+
+  // reports that a non-blocking socket is not ready, as ::recv() would have:
+  static auto set_would_block(const char *location) -> void {
+#if !defined(PLATFORM_WINDOWS)
+    last_error = EWOULDBLOCK;
+#else
+    last_error = WSAEWOULDBLOCK;
+#endif
+    last_error_location = location;
+  }
+
   static auto exception_thrown() -> bool {
     if (last_error_gai) {
       // throw script exception:
@@ -170,15 +191,103 @@ namespace Net {
     return addr;
   }
 
+  // inbound data of a socket watched by the reactor, filled by the reactor thread and drained by scripts:
+  struct RingBuffer {
+    vector<uint8_t> data;
+    uint head = 0;  // offset of the first unread byte
+    uint used = 0;
+
+    auto capacity() const -> uint { return data.size(); }
+    auto space() const -> uint { return capacity() - used; }
+
+    // the (up to two) contiguous free regions following the unread bytes:
+#if defined(PLATFORM_LINUX)
+    auto freeRegions(iovec regions[2]) -> uint {
+      uint tail = (head + used) % capacity();
+      uint first = min(space(), capacity() - tail);
+      regions[0] = {data.data() + tail, first};
+      regions[1] = {data.data(), space() - first};
+      return regions[1].iov_len ? 2 : 1;
+    }
+#endif
+    auto commit(uint size) -> void { used += size; }
+
+    auto read(uint8_t *output, uint size) -> uint {
+      size = min(size, used);
+      uint first = min(size, capacity() - head);
+      memory::copy(output, data.data() + head, first);
+      memory::copy(output + first, data.data(), size - first);
+      head = (head + size) % capacity();
+      used -= size;
+      return size;
+    }
+  };
+
+  struct Socket;
+
+  // host-side I/O for script sockets. On Linux a background thread waits on epoll for every watched socket, reads
+  // inbound data into the socket's ring buffer and accepts pending connections, so that scripts make no syscall for a
+  // socket with nothing to read. Sockets that received data or connections or whose peer closed since scripts last
+  // asked are queued as ready events, which scripts drain in bulk with net::ready() or receive through net::on_ready()
+  // at the next scanline. Elsewhere, the same events are found with a single poll() over all watched sockets once per
+  // frame or whenever scripts ask for them.
+  struct Reactor {
+    enum : uint { Capacity = 64 * 1024, Backlog = 128, Events = 64 };
+
+    std::mutex mutex;
+    vector<Socket*> sockets;  // watched
+    vector<Socket*> ready;    // with events not yet drained by scripts
+    asIScriptFunction *callback = nullptr;
+    // flag of the console whose scripts registered the callback, as the reactor thread belongs to no console:
+    std::atomic<bool> *events = nullptr;
+
+#if defined(PLATFORM_LINUX)
+    map<int, Socket*> descriptors;  // buffered sockets by descriptor
+    int epfd = -1;
+    int wakefd = -1;
+    nall::thread thread;
+    volatile bool running = false;
+#endif
+
+    ~Reactor();
+
+    auto start() -> bool;
+    auto main(uintptr) -> void;
+    auto watch(Socket *socket, bool listener) -> void;
+    auto unwatch(Socket *socket) -> void;
+    auto rearm(Socket *socket) -> void;
+    auto signal(Socket *socket) -> void;
+    auto pollSockets() -> void;
+    auto drain() -> CScriptArray*;
+    auto setCallback(asIScriptFunction *cb) -> void;
+    auto deliver(uint vcounter) -> void;
+    auto reset() -> void;
+  };
+  extern Reactor reactor;
+
   struct Socket {
     int fd = -1;
 
+    // set while the reactor watches the socket; `buffered` when the reactor reads inbound data on its own thread:
+    bool watched = false;
+    bool buffered = false;
+    bool listener = false;
+    // below are guarded by the reactor mutex:
+    RingBuffer inbound;
+    vector<int> accepted;    // connections accepted by the reactor for a listening socket
+    bool eof = false;        // peer closed the connection (or it failed); no more data follows what is buffered
+    bool throttled = false;  // reactor stopped reading since the ring buffer is full
+    bool queued = false;     // in the reactor's ready list
+
     // already-created socket:
     Socket(int fd) : fd(fd) {
+      ref = 1;
     }
 
+    int type = SOCK_STREAM;
+
     // create a new socket:
-    Socket(int family, int type, int protocol) {
+    Socket(int family, int type, int protocol) : type(type) {
       ref = 1;
 
       // create the socket:
@@ -260,6 +369,9 @@ namespace Net {
     }
 
     auto close(bool set_last_error = true) -> void {
+      // the descriptor may be reused as soon as it is closed:
+      if (watched) reactor.unwatch(this);
+
       int rc;
 #if !defined(PLATFORM_WINDOWS)
       rc = ::close(fd); set_last_error && (last_error_location = LOCATION " close");
@@ -308,8 +420,13 @@ namespace Net {
       last_error = 0;
       if (rc < 0) {
         last_error = sock_capture_error();
-        exception_thrown();
+#if !defined(PLATFORM_WINDOWS)
+        if (last_error == EINPROGRESS) last_error = 0;
+#endif
       }
+      // a non-blocking connect is usually still in progress; the reactor reports the socket once data arrives:
+      if (type == SOCK_STREAM && !watched) reactor.watch(this, false);
+      if (last_error) exception_thrown();
       return rc;
     }
 
@@ -320,21 +437,32 @@ namespace Net {
       if (rc < 0) {
         last_error = sock_capture_error();
         exception_thrown();
+        return rc;
       }
+      if (!watched) reactor.watch(this, true);
       return rc;
     }
 
     // accept a connection:
     auto accept() -> Socket* {
-      // non-blocking sockets don't require a poll() because accept() handles non-blocking scenario itself.
-
-      // accept incoming connection, discard client address:
-      int afd = ::accept(fd, nullptr, nullptr); last_error_location = LOCATION " accept";
+      int afd = -1;
       last_error = 0;
-      if (afd < 0) {
-        last_error = sock_capture_error();
-        exception_thrown();
-        return nullptr;
+      if (buffered) {
+        // take a connection the reactor already accepted:
+        std::lock_guard<std::mutex> lock(reactor.mutex);
+        if (!accepted) return nullptr;
+        afd = accepted.takeFirst();
+        if (throttled) reactor.rearm(this);
+      } else {
+        // non-blocking sockets don't require a poll() because accept() handles non-blocking scenario itself.
+
+        // accept incoming connection, discard client address:
+        afd = ::accept(fd, nullptr, nullptr); last_error_location = LOCATION " accept";
+        if (afd < 0) {
+          last_error = sock_capture_error();
+          exception_thrown();
+          return nullptr;
+        }
       }
 
       auto conn = new Socket(afd);
@@ -343,11 +471,59 @@ namespace Net {
         return nullptr;
       }
 
+      reactor.watch(conn, false);
       return conn;
     }
 
+    // number of received bytes buffered by the reactor:
+    auto get_available() -> uint {
+      if (!buffered) return 0;
+      std::lock_guard<std::mutex> lock(reactor.mutex);
+      return inbound.used;
+    }
+
+    // reads buffered data; returns 0 once the peer closed and everything was read, or -1 if nothing is buffered yet:
+    auto read_buffered(uint8_t *output, uint size) -> int {
+      std::lock_guard<std::mutex> lock(reactor.mutex);
+      if (!inbound.used) return eof ? 0 : -1;
+      uint length = inbound.read(output, size);
+      if (throttled) reactor.rearm(this);
+      return length;
+    }
+
+    // receives up to `size` bytes; returns 0 once the peer closed the connection, or -1 if nothing was received:
+    auto receive(uint8_t *output, uint size) -> int {
+      if (buffered) {
+        int rc = read_buffered(output, size);
+        last_error = 0;
+        if (rc == 0) close();
+        return rc;
+      }
+
+#if !defined(PLATFORM_WINDOWS)
+      int rc = ::recv(fd, output, size, 0); last_error_location = LOCATION " recv";
+#else
+      int rc = ::recv(fd, (char *)output, size, 0); last_error_location = LOCATION " recv";
+#endif
+      last_error = 0;
+      if (rc < 0) {
+        last_error = sock_capture_error();
+        exception_thrown();
+        return -1;
+      }
+      if (rc == 0) close();
+      return rc;
+    }
+
     // attempt to receive data:
     auto recv(int offs, int size, CScriptArray* buffer) -> int {
+      if (buffered) {
+        int rc = read_buffered((uint8_t *)buffer->At(offs), size);
+        last_error = 0;
+        if (rc < 0) set_would_block(LOCATION " recv");
+        return rc;
+      }
+
 #if !defined(PLATFORM_WINDOWS)
       int rc = ::recv(fd, buffer->At(offs), size, 0); last_error_location = LOCATION " recv";
 #else
@@ -414,6 +590,23 @@ namespace Net {
       uint8_t rawbuf[4096];
       uint64_t total = 0;
 
+      while (buffered) {
+        int rc = read_buffered(rawbuf, 4096);
+        last_error = 0;
+        if (rc < 0) return total;
+        if (rc == 0) {
+          // remote peer closed the connection
+          close();
+          return total;
+        }
+
+        // append to string:
+        uint64_t to = s.size();
+        s.resize(s.size() + rc);
+        memory::copy(s.get() + to, rawbuf, rc);
+        total += rc;
+      }
+
       for (;;) {
 #if !defined(PLATFORM_WINDOWS)
         int rc = ::recv(fd, rawbuf, 4096, 0); last_error_location = LOCATION " recv";
@@ -444,6 +637,20 @@ namespace Net {
       uint8_t rawbuf[4096];
       uint64_t total = 0;
 
+      while (buffered) {
+        int rc = read_buffered(rawbuf, 4096);
+        last_error = 0;
+        if (rc < 0) return total;
+        if (rc == 0) {
+          close();
+          return total;
+        }
+
+        // append to buffer:
+        buffer.appends({rawbuf, (uint)rc});
+        total += rc;
+      }
+
       for (;;) {
 #if !defined(PLATFORM_WINDOWS)
         int rc = ::recv(fd, rawbuf, 4096, 0); last_error_location = LOCATION " recv";
@@ -467,6 +674,31 @@ namespace Net {
       }
     }
 
+    // sends both buffers with a single syscall; returns the number of bytes sent, or -1 if the socket would block.
+    // Other errors close the socket and return 0 rather than throwing, so that one broken connection does not abort
+    // sending to the others:
+    auto send_gather(const uint8_t *first, uint firstSize, const uint8_t *second, uint64_t secondSize) -> int64_t {
+#if !defined(PLATFORM_WINDOWS)
+      iovec buffers[2] = {{(void *)first, firstSize}, {(void *)second, (size_t)secondSize}};
+      msghdr header{};
+      header.msg_iov = buffers;
+      header.msg_iovlen = 2;
+      int64_t rc = ::sendmsg(fd, &header, MSG_NOSIGNAL); last_error_location = LOCATION " sendmsg";
+#else
+      WSABUF buffers[2] = {{firstSize, (CHAR *)first}, {(ULONG)secondSize, (CHAR *)second}};
+      DWORD sent = 0;
+      int64_t rc = ::WSASend(fd, buffers, 2, &sent, 0, nullptr, nullptr) == 0 ? (int64_t)sent : -1; last_error_location = LOCATION " WSASend";
+#endif
+      last_error = 0;
+      if (rc < 0) {
+        last_error = sock_capture_error();
+        if (would_block()) return -1;
+        close(false);
+        return 0;
+      }
+      return rc;
+    }
+
     auto send_buffer(array_view<uint8_t> buffer) -> int {
 #if !defined(PLATFORM_WINDOWS)
       int rc = ::send(fd, buffer.data(), buffer.size(), 0); last_error_location = LOCATION " send";
@@ -486,6 +718,281 @@ namespace Net {
     }
   };
 
+  Reactor reactor;
+
+  Reactor::~Reactor() {
+#if defined(PLATFORM_LINUX)
+    if (running) {
+      running = false;
+      uint64_t one = 1;
+      (void)!::write(wakefd, &one, sizeof(one));
+      thread.join();
+    }
+    if (epfd >= 0) ::close(epfd);
+    if (wakefd >= 0) ::close(wakefd);
+#endif
+  }
+
+  // starts the reactor thread on first use:
+  auto Reactor::start() -> bool {
+#if defined(PLATFORM_LINUX)
+    if (running) return true;
+    if (epfd < 0) epfd = epoll_create1(EPOLL_CLOEXEC);
+    if (wakefd < 0) wakefd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (epfd < 0 || wakefd < 0) return false;
+
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.fd = wakefd;
+    epoll_ctl(epfd, EPOLL_CTL_ADD, wakefd, &event);
+
+    running = true;
+    thread = nall::thread::create({&Reactor::main, this});
+    return true;
+#else
+    return false;
+#endif
+  }
+
+#if defined(PLATFORM_LINUX)
+  // reactor thread: reads whatever arrives on watched sockets until the ring buffers are full:
+  auto Reactor::main(uintptr) -> void {
+    epoll_event events[Events];
+
+    while (running) {
+      int count = epoll_wait(epfd, events, Events, -1);
+      if (count < 0 && errno != EINTR) break;
+
+      std::lock_guard<std::mutex> lock(mutex);
+      for (int n = 0; n < count; n++) {
+        int fd = events[n].data.fd;
+        if (fd == wakefd) {
+          uint64_t value;
+          (void)!::read(wakefd, &value, sizeof(value));
+          continue;
+        }
+
+        // the socket may have been unwatched since epoll_wait() returned:
+        auto found = descriptors.find(fd);
+        if (!found) continue;
+        auto socket = found();
+        bool changed = false;
+
+        if (socket->listener) {
+          while (socket->accepted.size() < Backlog) {
+            int afd = accept4(fd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+            if (afd < 0) break;
+            int yes = 1;
+            setsockopt(afd, IPPROTO_TCP, TCP_NODELAY, &yes, sizeof(int));
+            socket->accepted.append(afd);
+            changed = true;
+          }
+
+          if (socket->accepted.size() >= Backlog) {
+            // stop accepting until scripts take some of the pending connections:
+            socket->throttled = true;
+            epoll_event event{};
+            event.data.fd = fd;
+            epoll_ctl(epfd, EPOLL_CTL_MOD, fd, &event);
+          }
+        } else {
+          while (socket->inbound.space()) {
+            iovec regions[2];
+            ssize_t rc = readv(fd, regions, socket->inbound.freeRegions(regions));
+            if (rc < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)) break;
+            if (rc <= 0) {
+              // closed by peer or failed; scripts read what is left, then see the connection closed:
+              socket->eof = true;
+              epoll_ctl(epfd, EPOLL_CTL_DEL, fd, nullptr);
+              changed = true;
+              break;
+            }
+            socket->inbound.commit(rc);
+            changed = true;
+          }
+
+          if (!socket->inbound.space() && !socket->eof) {
+            // stop reading until scripts make room:
+            socket->throttled = true;
+            epoll_event event{};
+            event.data.fd = fd;
+            epoll_ctl(epfd, EPOLL_CTL_MOD, fd, &event);
+          }
+        }
+
+        if (changed) signal(socket);
+      }
+    }
+  }
+#else
+  auto Reactor::main(uintptr) -> void {
+  }
+#endif
+
+  auto Reactor::watch(Socket *socket, bool listener) -> void {
+    std::lock_guard<std::mutex> lock(mutex);
+    socket->watched = true;
+    socket->listener = listener;
+    sockets.append(socket);
+
+#if defined(PLATFORM_LINUX)
+    if (!start()) return;
+    if (!listener) socket->inbound.data.resize(Capacity);
+
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.fd = socket->fd;
+    if (epoll_ctl(epfd, EPOLL_CTL_ADD, socket->fd, &event) < 0) return;
+    descriptors.insert(socket->fd, socket);
+    socket->buffered = true;
+#endif
+  }
+
+  auto Reactor::unwatch(Socket *socket) -> void {
+    std::lock_guard<std::mutex> lock(mutex);
+#if defined(PLATFORM_LINUX)
+    if (socket->buffered) {
+      epoll_ctl(epfd, EPOLL_CTL_DEL, socket->fd, nullptr);
+      descriptors.remove(socket->fd);
+    }
+#endif
+    for (auto afd : socket->accepted) {
+#if !defined(PLATFORM_WINDOWS)
+      ::close(afd);
+#else
+      ::closesocket(afd);
+#endif
+    }
+    socket->accepted.reset();
+    if (auto index = sockets.find(socket)) sockets.remove(*index);
+    if (auto index = ready.find(socket)) ready.remove(*index);
+    socket->watched = false;
+    socket->buffered = false;
+    socket->queued = false;
+  }
+
+  // resumes reading into a full ring buffer (or accepting into a full backlog); called with the mutex held:
+  auto Reactor::rearm(Socket *socket) -> void {
+#if defined(PLATFORM_LINUX)
+    socket->throttled = false;
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.fd = socket->fd;
+    epoll_ctl(epfd, EPOLL_CTL_MOD, socket->fd, &event);
+#endif
+  }
+
+  // queues a ready event for the socket; called with the mutex held:
+  auto Reactor::signal(Socket *socket) -> void {
+    if (!socket->queued) {
+      socket->queued = true;
+      ready.append(socket);
+    }
+    if (callback) *events = true;
+  }
+
+  // finds ready sockets without a reactor thread; called with the mutex held:
+  auto Reactor::pollSockets() -> void {
+#if !defined(PLATFORM_LINUX)
+    if (!sockets) return;
+
+  #if defined(PLATFORM_WINDOWS)
+    vector<WSAPOLLFD> fds;
+  #else
+    vector<pollfd> fds;
+  #endif
+    for (auto socket : sockets) {
+      fds.append({});
+      fds.last().fd = socket->fd;
+      fds.last().events = POLLIN;
+    }
+
+  #if defined(PLATFORM_WINDOWS)
+    if (WSAPoll(fds.data(), fds.size(), 0) <= 0) return;
+  #else
+    if (poll(fds.data(), fds.size(), 0) <= 0) return;
+  #endif
+    for (uint n : range(fds.size())) {
+      if (fds[n].revents) signal(sockets[n]);
+    }
+#endif
+  }
+
+  // hands every ready socket to the script and clears the ready list:
+  auto Reactor::drain() -> CScriptArray* {
+    auto engine = ::SuperFamicom::script.engine;
+    auto array = CScriptArray::Create(engine->GetTypeInfoByDecl("array<net::Socket@>"));
+
+    std::lock_guard<std::mutex> lock(mutex);
+    pollSockets();
+    for (auto socket : ready) {
+      socket->queued = false;
+      array->InsertLast(&socket);
+    }
+    ready.reset();
+    return array;
+  }
+
+  auto Reactor::setCallback(asIScriptFunction *cb) -> void {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (callback) callback->Release();
+    callback = cb;
+    if (callback) callback->AddRef();
+    events = &::SuperFamicom::script.netEvents;
+#if defined(PLATFORM_LINUX)
+    ::SuperFamicom::script.netEvents = callback && ready;
+#else
+    // polled once per frame while a callback is registered:
+    ::SuperFamicom::script.netEvents = (bool)callback;
+#endif
+  }
+
+  // called by the emulation thread on every scanline while net::on_ready() has a callback registered:
+  auto Reactor::deliver(uint vcounter) -> void {
+#if !defined(PLATFORM_LINUX)
+    // without a reactor thread, check for events once per frame:
+    if (vcounter != 0) return;
+#endif
+    asIScriptFunction *cb;
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+#if defined(PLATFORM_LINUX)
+      ::SuperFamicom::script.netEvents = false;
+#endif
+      cb = callback;
+    }
+    if (!cb) return;
+
+    auto sockets = drain();
+    if (sockets->GetSize()) {
+      executeCallback(cb, [&](asIScriptContext *ctx) {
+        ctx->SetArgObject(0, sockets);
+      });
+    }
+    sockets->Release();
+  }
+
+  auto Reactor::reset() -> void {
+    setCallback(nullptr);
+    std::lock_guard<std::mutex> lock(mutex);
+    for (auto socket : ready) socket->queued = false;
+    ready.reset();
+    ::SuperFamicom::script.netEvents = false;
+  }
+
+  static auto ready() -> CScriptArray* {
+    return reactor.drain();
+  }
+
+  static auto on_ready(asIScriptFunction *cb) -> void {
+    reactor.setCallback(cb);
+    if (cb) {
+      hooks.track(cb, "net:ready", [] { reactor.setCallback(nullptr); });
+    } else {
+      hooks.untrack("net:ready");
+    }
+  }
+
   static auto create_socket(Address *addr) -> Socket* {
     auto socket = new Socket(addr->info->ai_family, addr->info->ai_socktype, addr->info->ai_protocol);
     if (!*socket) {
@@ -499,6 +1006,18 @@ namespace Net {
     uint8           opcode;
     vector<uint8_t> bytes;
 
+    // released messages keep their buffers for the next messages received or created:
+    enum : uint { PoolSize = 64 };
+    inline static vector<WebSocketMessage*> pool;
+
+    static auto acquire(uint8 opcode) -> WebSocketMessage* {
+      if (!pool) return new WebSocketMessage(opcode);
+      auto message = pool.takeLast();
+      message->opcode = opcode;
+      message->ref = 1;
+      return message;
+    }
+
     WebSocketMessage(uint8 opcode) : opcode(opcode)
     {
       ref = 1;
@@ -510,8 +1029,14 @@ namespace Net {
       ref++;
     }
     void release() {
-      if (--ref == 0)
+      if (--ref != 0) return;
+      if (pool.size() >= PoolSize) {
         delete this;
+        return;
+      }
+      // shrinking keeps the capacity:
+      bytes.reallocate(0);
+      pool.append(this);
     }
 
     auto get_opcode() -> uint8 { return opcode; }
@@ -540,28 +1065,89 @@ namespace Net {
     }
 
     auto set_payload_as_string(string *s) -> void {
-      bytes.resize(s->size());
+      bytes.reallocate(s->size());
       memory::copy(bytes.data(), s->data(), s->size());
     }
 
     auto set_payload_as_array(CScriptArray *a) -> void {
-      bytes.resize(a->GetSize());
-      memory::copy(bytes.data(), a->At(0), a->GetSize());
+      bytes.reallocate(a->GetSize());
+      if (a->GetSize()) memory::copy(bytes.data(), a->At(0), a->GetSize());
     }
   };
 
   auto create_web_socket_message(uint8 opcode) -> WebSocketMessage* {
-    return new WebSocketMessage(opcode);
+    return WebSocketMessage::acquire(opcode);
+  }
+
+  // XORs `size` bytes of `source` with the masking key into `target` (which may be `source`), starting at byte `offset`
+  // of the key; returns the key offset of the byte that follows. The key is rotated to the starting offset so that the
+  // bulk of the payload is unmasked a 64-bit word at a time:
+  static auto unmask(uint8_t *target, const uint8_t *source, uint64_t size, const uint8_t key[4], uint offset) -> uint {
+    uint8_t rotated[8];
+    for (uint n : range(8)) rotated[n] = key[(offset + n) & 3];
+    uint64_t word;
+    memory::copy(&word, rotated, 8);
+
+    uint64_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+      uint64_t data;
+      memory::copy(&data, source + i, 8);
+      data ^= word;
+      memory::copy(target + i, &data, 8);
+    }
+    for (; i < size; i++) target[i] = source[i] ^ rotated[i & 7];
+
+    return (offset + size) & 3;
+  }
+
+  // writes a frame header for a payload of `len` bytes into `frame`, without the masking key; returns its size:
+  static auto frame_header(uint8_t frame[10], uint8 opcode, uint64_t len, bool masked) -> uint {
+    uint size = 0;
+    bool fin = true;
+    frame[size++] = (fin << 7) | (opcode & 0x0F);
+
+    if (len > 65535) {
+      frame[size++] = (masked << 7) | 127;
+      // send big-endian 64-bit payload length:
+      for (int j = 0; j < 8; j++) {
+        frame[size++] = (len >> (7-j)*8) & 0xFF;
+      }
+    } else if (len > 125) {
+      frame[size++] = (masked << 7) | 126;
+      // send big-endian 16-bit payload length:
+      for (int j = 0; j < 2; j++) {
+        frame[size++] = (len >> (1-j)*8) & 0xFF;
+      }
+    } else {
+      // 7-bit (ish) length:
+      frame[size++] = (masked << 7) | (len & 0x7F);
+    }
+    return size;
   }
 
+  // value of the Sec-WebSocket-Accept header in response to a Sec-WebSocket-Key:
+  static auto web_socket_accept(const string &key) -> string {
+    auto concat = string{key, string("258EAFA5-E914-47DA-95CA-C5AB0DC85B11")};
+    auto sha1 = nall::Hash::SHA1(concat).output();
+    return nall::Encode::Base64(sha1);
+  }
+
+  // masking keys for frames sent by clients and Sec-WebSocket-Key values; RFC 6455 5.3 requires them to be unpredictable,
+  // so they come from a cryptographically secure generator seeded from the system's entropy source:
+  nall::CSPRNG::XChaCha20 mask_random;
+
   struct WebSocket {
     Socket* socket;
+    bool deflate;  // permessage-deflate was negotiated
+    bool client;   // client side of the connection; masks the frames it sends and expects unmasked frames
 
-    WebSocket(Socket* socket) : socket(socket) {
+    WebSocket(Socket* socket, bool deflate = false, bool client = false) : socket(socket), deflate(deflate), client(client) {
       socket->addRef();
       ref = 1;
     }
     ~WebSocket() {
+      if (message) message->release();
+      if (control) control->release();
       socket->release();
     }
 
@@ -576,183 +1162,315 @@ namespace Net {
 
     operator bool() { return *socket; }
 
-    vector<uint8_t> frame;
-    WebSocketMessage *message = nullptr;
-
-    // attempt to receive data:
+    // messages larger than this (after inflating) fail the connection:
+    enum : uint64_t { MaxMessage = 16 * 1024 * 1024 };
+    // payload that does not fit into the input buffer is received directly into the message:
+    enum : uint { InputSize = 16 * 1024 };
+
+    // received data not parsed yet:
+    uint8_t input[InputSize];
+    uint inputHead = 0;
+    uint inputSize = 0;
+
+    // the frame parser keeps its state across process() calls so that nothing received is read twice:
+    enum { HEADER, PAYLOAD } state = HEADER;
+    uint8_t header[14];
+    uint headerSize = 0;  // header bytes received
+    uint headerNeed = 2;  // header bytes known to be needed so far
+
+    uint8_t opcode = 0;
+    bool fin = false;
+    uint64_t remaining = 0;  // payload bytes of the current frame not received yet
+    bool masked = false;
+    uint8_t mask_key[4];
+    uint mask_offset = 0;
+
+    WebSocketMessage *message = nullptr;  // data message assembled from one or more frames
+    WebSocketMessage *control = nullptr;  // control frame, which may arrive between the fragments of a data message
+    bool compressed = false;              // data message has RSV1 set
+    vector<uint8_t> inflated;             // reused output buffer for permessage-deflate
+
+    // frames not yet accepted by the socket; sent before anything else:
+    vector<uint8_t> outbound;
+    uint64_t outboundSent = 0;
+
+    // attempt to receive data; returns the next complete message, or null if none is complete yet:
     auto process() -> WebSocketMessage* {
-      if (!*socket) {
-        // TODO: throw exception if socket closed?
-        printf("[%d] invalid socket!\n", socket->fd);
-        return nullptr;
-      }
+      if (!*socket) return nullptr;
+      flush();
 
-      // Receive data and append to current frame:
-      auto rc = socket->recv_buffer(frame);
-      // No data ready to recv:
-      if (rc == 0) {
-        printf("[%d] no data\n", socket->fd);
-        return nullptr;
+      while (*socket) {
+        if (state == HEADER) {
+          if (!receiveHeader()) return nullptr;
+          if (!parseHeader()) return nullptr;
+        }
+
+        if (state == PAYLOAD) {
+          if (!receivePayload()) return nullptr;
+          state = HEADER;
+          headerSize = 0;
+          headerNeed = 2;
+          if (auto completed = completeFrame()) return completed;
+        }
       }
 
-      // check start of frame:
-      uint minsize = 2;
-      if (frame.size() < minsize) {
-        printf("[%d] frame too small (%d) to read opcode and payload length bytes (%d)\n", socket->fd, frame.size(), minsize);
-        return nullptr;
+      return nullptr;
+    }
+
+    // refills the empty input buffer; false if nothing was received:
+    auto fetch() -> bool {
+      inputHead = 0;
+      inputSize = 0;
+      int rc = socket->receive(input, InputSize);
+      if (rc <= 0) return false;
+      inputSize = rc;
+      return true;
+    }
+
+    auto receiveHeader() -> bool {
+      // headerNeed never exceeds 2 + 8 + 4 bytes; clamping it lets the compiler see that the copy stays within header:
+      while (headerSize < headerNeed) {
+        if (inputHead == inputSize && !fetch()) return false;
+        uint size = min(min<uint>(headerNeed, sizeof(header)) - headerSize, inputSize - inputHead);
+        memcpy(header + headerSize, input + inputHead, size);
+        inputHead += size;
+        headerSize += size;
+
+        if (headerSize == 2) {
+          // the second byte determines the size of the rest of the header:
+          uint len = header[1] & 0x7F;
+          if (len == 126) headerNeed += 2;
+          else if (len == 127) headerNeed += 8;
+          if (header[1] & 0x80) headerNeed += 4;
+        }
       }
+      return true;
+    }
 
+    // validates the received frame header and prepares to receive its payload; fails the connection if it is invalid:
+    auto parseHeader() -> bool {
       uint i = 0;
 
-      bool fin = frame[i] & 0x80;
-      // 3 other reserved bits here
-      uint8_t opcode = frame[i] & 0x0F;
+      fin = header[i] & 0x80;
+      bool rsv1 = header[i] & 0x40;
+      bool rsv23 = header[i] & 0x30;
+      opcode = header[i] & 0x0F;
       i++;
 
-      bool mask = frame[i] & 0x80;
-      uint64_t len = frame[i] & 0x7F;
+      bool mask = header[i] & 0x80;
+      uint64_t len = header[i] & 0x7F;
       i++;
 
-      // determine minimum size of frame to parse:
-      if (len == 126) minsize += 2;
-      else if (len == 127) minsize += 8;
-
-      // need more data?
-      if (frame.size() < minsize) {
-        printf("[%d] frame too small (%d) to read additional payload length bytes (%d)\n", socket->fd, frame.size(), minsize);
-        return nullptr;
-      }
-
       if (len == 126) {
         // len is 16-bit
         len = 0;
         for (int j = 0; j < 2; j++) {
           len <<= 8u;
-          len |= frame[i++];
+          len |= header[i++];
         }
       } else if (len == 127) {
         // len is 64-bit
         len = 0;
         for (int j = 0; j < 8; j++) {
           len <<= 8u;
-          len |= frame[i++];
+          len |= header[i++];
         }
       }
 
-      uint8_t mask_key[4] = {0};
+      // frames received from clients must be masked, and frames received from servers must not be:
+      if (mask == client) return fail(1002);
+      masked = mask;
+      if (masked) {
+        for (auto &mask_byte : mask_key) {
+          mask_byte = header[i++];
+        }
+      }
+      mask_offset = 0;
+
+      if (rsv23) return fail(1002);
+
+      if (opcode >= 8) {
+        // control frames must not be fragmented or compressed and carry at most 125 bytes:
+        if (opcode > 10 || !fin || rsv1 || len > 125) return fail(1002);
+        if (!control) control = WebSocketMessage::acquire(opcode);
+        control->opcode = opcode;
+        control->bytes.reserve(len);
+      } else if (opcode == 0) {
+        // continuation of a fragmented message:
+        if (!message || rsv1) return fail(1002);
+        if (len > MaxMessage - message->bytes.size()) return fail(1009);
+      } else {
+        // first frame of a new message:
+        if (opcode > 2 || message || (rsv1 && !deflate)) return fail(1002);
+        if (len > MaxMessage) return fail(1009);
+        message = WebSocketMessage::acquire(opcode);
+        compressed = rsv1;
+      }
 
-      if (mask) {
-        minsize += 4;
-        if (frame.size() < minsize) {
-          printf("[%d] frame too small (%d) to read mask key bytes (%d)\n", socket->fd, frame.size(), minsize);
-          return nullptr;
+      if (opcode < 8) message->bytes.reserve(message->bytes.size() + len);
+      remaining = len;
+      state = PAYLOAD;
+      return true;
+    }
+
+    // receives and unmasks the payload of the current frame; false until all of it arrived:
+    auto receivePayload() -> bool {
+      auto &bytes = opcode >= 8 ? control->bytes : message->bytes;
+
+      while (remaining) {
+        uint64_t offset = bytes.size();
+
+        if (inputHead < inputSize) {
+          // unmask buffered input into the message:
+          uint size = min<uint64_t>(remaining, inputSize - inputHead);
+          bytes.reallocate(offset + size);
+          if (masked) mask_offset = unmask(bytes.data() + offset, input + inputHead, size, mask_key, mask_offset);
+          else memory::copy(bytes.data() + offset, input + inputHead, size);
+          inputHead += size;
+          remaining -= size;
+          continue;
         }
 
-        // read mask key:
-        for (unsigned char &mask_byte : mask_key) {
-          mask_byte = frame[i++];
+        if (remaining < InputSize) {
+          // small payloads are received along with the frames that follow them:
+          if (!fetch()) return false;
+          continue;
         }
-        //printf("mask_key is %02x%02x%02x%02x\n", mask_key[0], mask_key[1], mask_key[2], mask_key[3]);
-      } else {
-        //printf("frame is not masked!\n");
-        asGetActiveContext()->SetException("WebSocket frame received from client must be masked", true);
-        return nullptr;
-      }
 
-      // not enough data in frame yet?
-      if (frame.size() - i < len) {
-        printf("[%d] frame too small (%d) to read full payload (%d)\n", socket->fd, frame.size(), i + len);
-        return nullptr;
+        // receive large payloads straight into the message and unmask them in place:
+        uint size = min<uint64_t>(remaining, 1u << 30);
+        bytes.reallocate(offset + size);
+        int rc = socket->receive(bytes.data() + offset, size);
+        if (rc <= 0) {
+          bytes.reallocate(offset);
+          return false;
+        }
+        bytes.reallocate(offset + rc);
+        if (masked) mask_offset = unmask(bytes.data() + offset, bytes.data() + offset, rc, mask_key, mask_offset);
+        remaining -= rc;
       }
 
-      // For any opcode but 0 (continuation), start a new message:
-      if (opcode != 0) {
-        //printf("new message with opcode = %d\n", opcode);
-        message = new WebSocketMessage(opcode);
-      }
+      return true;
+    }
 
-      // append payload data to message buffer:
-      auto payload = frame.view(i, len);
-      if (mask) {
-        // Unmask the payload with the mask_key and append to message:
-        //printf("append masked payload of size %d\n", payload.size());
-        uint k = 0;
-        for (uint8_t byte : payload) {
-          message->bytes.append(byte ^ mask_key[k]);
-          k = (k + 1) & 3;
-        }
-      } else {
-        // Append unmasked payload:
-        //printf("append unmasked payload of size %d\n", payload.size());
-        message->bytes.appends(payload);
+    // returns the message completed by the frame just received, if any:
+    auto completeFrame() -> WebSocketMessage* {
+      if (opcode >= 8) {
+        auto completed = control;
+        control = nullptr;
+        return completed;
       }
 
-      // clear out already-read data:
-      frame.removeLeft(i + len);
+      // wait for the remaining fragments:
+      if (!fin) return nullptr;
 
-      // if no FIN flag set, wait for more frames:
-      if (!fin) {
-        printf("[%d] FIN not set\n", socket->fd);
+      if (compressed && !inflate()) {
+        message->release();
+        message = nullptr;
+        fail(1007);
         return nullptr;
       }
 
-      // return final message:
-      printf("[%d] FIN set; returning message\n", socket->fd);
-      auto tmp = message;
+      auto completed = message;
       message = nullptr;
-      return tmp;
+      return completed;
     }
 
-    // send a message:
-    auto send(WebSocketMessage* msg) -> void {
-      vector<uint8_t> outframe;
-
-      uint64_t len = msg->bytes.size();
-      bool fin = true;
-
-      outframe.append((fin << 7) | (msg->opcode & 0x0F));
+    // inflates the payload of a compressed message in place:
+    auto inflate() -> bool {
+      auto &bytes = message->bytes;
+      // restore the end of the flushed deflate stream that the sender removed and terminate it with an empty final
+      // block, as the inflater expects a complete stream:
+      static const uint8_t tail[] = {0x00, 0x00, 0xff, 0xff, 0x03, 0x00};
+      bytes.appends({tail, sizeof(tail)});
 
-      bool masked = false;
-      if (len > 65536) {
-        outframe.append((masked << 7) | 127);
-        // send big-endian 64-bit payload length:
-        for (int j = 0; j < 8; j++) {
-          outframe.append((len >> (7-j)*8) & 0xFF);
-        }
-      } else if (len > 125) {
-        outframe.append((masked << 7) | 126);
-        // send big-endian 16-bit payload length:
-        for (int j = 0; j < 2; j++) {
-          outframe.append((len >> (1-j)*8) & 0xFF);
+      uint64_t size = max<uint64_t>(inflated.capacity(), bytes.size() * 4);
+      for (;;) {
+        size = min<uint64_t>(size, MaxMessage);
+        inflated.reallocate(size);
+        unsigned long targetLength = size, sourceLength = bytes.size();
+        int result = Decode::puff::puff(inflated.data(), &targetLength, bytes.data(), &sourceLength);
+        if (result == 0) {
+          inflated.reallocate(targetLength);
+          break;
         }
-      } else {
-        // 7-bit (ish) length:
-        outframe.append((masked << 7) | (len & 0x7F));
+        // only retry if the output did not fit:
+        if (result != 1 || size == MaxMessage) return false;
+        size *= 2;
       }
 
-      uint8_t mask_key[4] = {0};
-      if (masked) {
-        // TODO: build and send mask_key
-      }
+      // the compressed buffer is reused as the next output buffer:
+      std::swap(bytes, inflated);
+      return true;
+    }
 
-      // append payload to frame:
-      outframe.appends(msg->bytes);
+    // sends a close frame with the status code and closes the connection:
+    auto fail(uint16_t code) -> bool {
+      uint8_t status[2] = {uint8_t(code >> 8), uint8_t(code)};
+      sendFrame(8, status, sizeof(status));
+      if (*socket) socket->close();
+      return false;
+    }
 
-      // try to send frame:
-      int rc = socket->send_buffer(outframe);
-      if (rc == 0) {
-        // remote peer closed the connection:
-        return;
+    // sends as much of the outbound frames as the socket accepts:
+    auto flush() -> void {
+      while (outboundSent < outbound.size() && *socket) {
+        int rc = socket->send_buffer({outbound.data() + outboundSent, outbound.size() - outboundSent});
+        if (rc <= 0) break;
+        outboundSent += rc;
       }
-      if (rc < 0) {
-        // TODO: maintain sending state machine
-        printf("[%d] send() error!\n", socket->fd);
-        return;
+      if (outboundSent == outbound.size()) {
+        // shrinking keeps the capacity:
+        outbound.reallocate(0);
+        outboundSent = 0;
       }
-      if (rc < outframe.size()) {
-        printf("[%d] send() failed to send entire frame!\n", socket->fd);
-        return;
+    }
+
+    // appends to the pending outbound data:
+    auto queue(const uint8_t *data, uint64_t size) -> uint8_t* {
+      uint64_t offset = outbound.size();
+      outbound.reallocate(offset + size);
+      if (data) memory::copy(outbound.data() + offset, data, size);
+      return outbound.data() + offset;
+    }
+
+    // sends an already framed header and its payload. While nothing is pending, both are written with a single gather
+    // syscall straight from the caller's buffers; only what the socket does not accept is copied to be sent later:
+    auto sendFramed(const uint8_t *frame, uint size, const uint8_t *payload, uint64_t len) -> void {
+      if (!*socket) return;
+
+      uint64_t sent = 0;
+      if (outboundSent == outbound.size()) {
+        int64_t rc = socket->send_gather(frame, size, payload, len);
+        if (rc > 0) sent = rc;
+        if (!*socket) return;
       }
+
+      if (sent < size) queue(frame + sent, size - sent);
+      uint64_t payloadSent = sent > size ? sent - size : 0;
+      if (payloadSent < len) queue(payload + payloadSent, len - payloadSent);
+      flush();
+    }
+
+    // frames and sends a payload; clients send a masked copy of it:
+    auto sendFrame(uint8 opcode, const uint8_t *payload, uint64_t len) -> void {
+      if (!*socket) return;
+
+      uint8_t frame[14];
+      uint size = frame_header(frame, opcode, len, client);
+      if (!client) return sendFramed(frame, size, payload, len);
+
+      auto key = (uint32_t)mask_random.random();
+      memory::copy(frame + size, &key, 4);
+      queue(frame, size + 4);
+      if (len) unmask(queue(nullptr, len), payload, len, frame + size, 0);
+      flush();
+    }
+
+    // send a message; data the socket does not accept yet is sent by the following send() or process() calls.
+    // Messages are sent uncompressed, which permessage-deflate permits:
+    auto send(WebSocketMessage* msg) -> void {
+      sendFrame(msg->opcode, msg->bytes.data(), msg->bytes.size());
     }
   };
 
@@ -765,6 +1483,7 @@ namespace Net {
     vector<string> request_lines;
 
     string ws_key;
+    bool deflate = false;  // client offered permessage-deflate
 
     enum {
       EXPECT_GET_REQUEST = 0,
@@ -803,6 +1522,7 @@ namespace Net {
       request.reset();
       request_lines.reset();
       ws_key.reset();
+      deflate = false;
     }
 
     auto base64_decode(const string& text) -> vector<uint8_t> {
@@ -872,11 +1592,12 @@ namespace Net {
 
       if (state == EXPECT_GET_REQUEST) {
         // build up GET request from client:
-        if (socket->recv_append(request) == 0) {
+        // nothing received yet is not an error; only give up once the peer closed the connection:
+        socket->recv_append(request);
+        if (!*socket) {
           //printf("socket closed!\n");
           reset();
           state = CLOSED;
-          socket->close(false);
           return nullptr;
         }
 
@@ -970,6 +1691,11 @@ namespace Net {
               goto response_sent;
             }
             req_ws_version = true;
+          } else if (header == "sec-websocket-extensions") {
+            // accept permessage-deflate among the offered extensions, whatever its parameters:
+            for (auto offer : value.split(",")) {
+              if (offer.split(";")[0].strip() == "permessage-deflate") deflate = true;
+            }
           }
         }
 
@@ -1005,9 +1731,7 @@ namespace Net {
       }
 
       if (state == SEND_HANDSHAKE) {
-        auto concat = string{ws_key, string("258EAFA5-E914-47DA-95CA-C5AB0DC85B11")};
-        auto sha1 = nall::Hash::SHA1(concat).output();
-        auto enc = nall::Encode::Base64(sha1);
+        auto enc = web_socket_accept(ws_key);
         auto buf = string{
           string(
             "HTTP/1.1 101 Switching Protocols\r\n"
@@ -1017,12 +1741,15 @@ namespace Net {
           ),
           // base64 encoded sha1 hash here
           enc,
-          string("\r\n\r\n")
+          string("\r\n"),
+          // received messages are inflated one at a time, so the client must not refer to previous messages:
+          deflate ? string("Sec-WebSocket-Extensions: permessage-deflate; client_no_context_takeover; server_no_context_takeover\r\n") : string(),
+          string("\r\n")
         };
         socket->send_buffer(buf);
 
         state = OPEN;
-        return new WebSocket(socket);
+        return new WebSocket(socket, deflate);
       }
 
       return nullptr;
@@ -1033,6 +1760,203 @@ namespace Net {
     return new WebSocketHandshaker(socket);
   }
 
+  // splits the absolute URI `ws://host:port/path...` into its parts; throws a script exception if it is invalid:
+  static auto parse_web_socket_uri(const string &uri, string &host, string &port, string &resource) -> bool {
+    // Split the absolute URI `ws://host:port/path.../path...` into `ws:` and `host:port/path.../path...`
+    auto scheme_rest = uri.split("//", 1);
+    if (scheme_rest.size() != 2) {
+      asGetActiveContext()->SetException("uri must be an absolute URI");
+      return false;
+    }
+    string scheme = scheme_rest[0];
+    if (scheme != "ws:") {
+      asGetActiveContext()->SetException("uri scheme must be `ws:`");
+      return false;
+    }
+
+    // Split the remaining `host:port/path.../path...` by the first '/':
+    auto rest = scheme_rest[1];
+    auto host_port_path = rest.split("/", 1);
+    if (host_port_path.size() == 0) host_port_path.append(rest);
+
+    // TODO: accommodate IPv6 addresses (e.g. `[::1]`)
+    host = host_port_path[0];
+    auto host_port = host_port_path[0].split(":");
+    if (host_port.size() == 2) {
+      host = host_port[0];
+      port = host_port[1];
+    } else {
+      port = "80";
+    }
+
+    resource = "/";
+    if (host_port_path.size() == 2) {
+      resource = string{"/", host_port_path[1]};
+    }
+    return true;
+  }
+
+  // connects to a WebSocket server, e.g. a local relay, and performs the client side of the opening handshake before
+  // handing the connection over to a WebSocket:
+  struct WebSocketClient {
+    Socket* socket = nullptr;
+    WebSocket* ws = nullptr;
+    string host;
+    string port;
+    string resource;
+
+    string ws_key;
+    uint8_t response[WebSocket::InputSize];
+    uint responseSize = 0;
+
+    enum {
+      CONNECTING = 0,
+      EXPECT_RESPONSE,
+      OPEN,
+      CLOSED
+    } state = CLOSED;
+
+    WebSocketClient(string uri) {
+      ref = 1;
+
+      if (!parse_web_socket_uri(uri, host, port, resource)) return;
+
+      auto addr = resolve_tcp(&host, &port);
+      if (!addr) return;
+      socket = create_socket(addr);
+      if (socket) socket->connect(addr);
+      delete addr;
+      if (!socket || !*socket) return;
+
+      uint8_t key[16];
+      for (auto &byte : key) byte = (uint8_t)mask_random.random();
+      ws_key = nall::Encode::Base64(key, sizeof(key));
+      state = CONNECTING;
+    }
+    ~WebSocketClient() {
+      if (ws) ws->release();
+      if (socket) socket->release();
+    }
+
+    int ref;
+    void addRef() {
+      ref++;
+    }
+    void release() {
+      if (--ref == 0)
+        delete this;
+    }
+
+    operator bool() { return state != CLOSED && socket && *socket; }
+
+    auto close() -> void {
+      if (socket && *socket) socket->close(false);
+      state = CLOSED;
+    }
+
+    // advances the connection; returns the WebSocket once the handshake completed, otherwise null:
+    auto process() -> WebSocket* {
+      if (state == CONNECTING) {
+        // wait until the connection is established:
+#if defined(PLATFORM_WINDOWS)
+        WSAPOLLFD fds{};
+        fds.fd = socket->fd;
+        fds.events = POLLOUT;
+        if (WSAPoll(&fds, 1, 0) <= 0) return nullptr;
+#else
+        pollfd fds{};
+        fds.fd = socket->fd;
+        fds.events = POLLOUT;
+        if (poll(&fds, 1, 0) <= 0) return nullptr;
+#endif
+        if (fds.revents & (POLLERR | POLLHUP)) {
+          close();
+          return nullptr;
+        }
+
+        auto request = string{
+          "GET ", resource, " HTTP/1.1\r\n",
+          "Host: ", host, ":", port, "\r\n",
+          "Upgrade: websocket\r\n",
+          "Connection: Upgrade\r\n",
+          "Sec-WebSocket-Key: ", ws_key, "\r\n",
+          "Sec-WebSocket-Version: 13\r\n",
+          // received messages are inflated one at a time, so the server must not refer to previous messages:
+          "Sec-WebSocket-Extensions: permessage-deflate; server_no_context_takeover\r\n",
+          "\r\n"
+        };
+        if (socket->send_buffer(request) != request.size()) {
+          close();
+          return nullptr;
+        }
+        state = EXPECT_RESPONSE;
+      }
+
+      if (state == EXPECT_RESPONSE) {
+        // the response is bounded by the input buffer of the WebSocket, which takes any frames received along with it:
+        int rc = socket->receive(response + responseSize, sizeof(response) - responseSize);
+        if (rc == 0) {
+          close();
+          return nullptr;
+        }
+        if (rc < 0) return nullptr;
+        responseSize += rc;
+
+        string text;
+        text.resize(responseSize);
+        memory::copy(text.get(), response, responseSize);
+        auto found = text.find("\r\n\r\n");
+        if (!found) {
+          if (responseSize == sizeof(response)) close();
+          return nullptr;
+        }
+        uint length = found.get() + 4;
+
+        bool upgraded = false;
+        bool accepted = false;
+        bool deflate = false;
+        auto lines = slice(text, 0, found.get()).split("\r\n");
+        auto status = lines[0].split(" ");
+        if (status.size() >= 2 && status[1] == "101") {
+          for (uint i = 1; i < lines.size(); i++) {
+            auto split = lines[i].split(":", 1);
+            if (split.size() != 2) continue;
+            auto header = split[0].downcase().strip();
+            auto value = split[1].strip();
+            if (header == "upgrade") {
+              upgraded = value.downcase() == "websocket";
+            } else if (header == "sec-websocket-accept") {
+              accepted = value == web_socket_accept(ws_key);
+            } else if (header == "sec-websocket-extensions") {
+              deflate = value.split(";")[0].strip() == "permessage-deflate";
+            }
+          }
+        }
+        if (!upgraded || !accepted) {
+          close();
+          return nullptr;
+        }
+
+        ws = new WebSocket(socket, deflate, true);
+        // frames that arrived with the response:
+        memory::copy(ws->input, response + length, responseSize - length);
+        ws->inputSize = responseSize - length;
+        state = OPEN;
+      }
+
+      if (state == OPEN) {
+        ws->addRef();
+        return ws;
+      }
+
+      return nullptr;
+    }
+  };
+
+  auto create_web_socket_client(string *uri) -> WebSocketClient* {
+    return new WebSocketClient(*uri);
+  }
+
   struct WebSocketServer {
     Socket* socket = nullptr;
     string host;
@@ -1064,38 +1988,7 @@ namespace Net {
 
       // use a default uri:
       if (!uri) uri = "ws://localhost:8080";
-
-      // Split the absolute URI `ws://host:port/path.../path...` into `ws:` and `host:port/path.../path...`
-      auto scheme_rest = uri.split("//", 1);
-      if (scheme_rest.size() == 0) {
-        asGetActiveContext()->SetException("uri must be an absolute URI");
-        return;
-      }
-      string scheme = scheme_rest[0];
-      if (scheme != "ws:") {
-        asGetActiveContext()->SetException("uri scheme must be `ws:`");
-        return;
-      }
-
-      // Split the remaining `host:port/path.../path...` by the first '/':
-      auto rest = scheme_rest[1];
-      auto host_port_path = rest.split("/", 1);
-      if (host_port_path.size() == 0) host_port_path.append(rest);
-
-      // TODO: accommodate IPv6 addresses (e.g. `[::1]`)
-      host = host_port_path[0];
-      auto host_port = host_port_path[0].split(":");
-      if (host_port.size() == 2) {
-        host = host_port[0];
-        port = host_port[1];
-      } else {
-        port = "80";
-      }
-
-      resource = "/";
-      if (host_port_path.size() == 2) {
-        resource = string{"/", host_port_path[1]};
-      }
+      if (!parse_web_socket_uri(uri, host, port, resource)) return;
 
       // resolve listening address:
       auto addr = resolve_tcp(&host, &port);
@@ -1170,6 +2063,22 @@ namespace Net {
     }
 
     auto get_clients() -> CScriptArray* { return clients; }
+
+    // sends the message to every open client. The frame is built once and written to each client together with the
+    // payload using gather I/O, so the payload is only copied for clients that cannot accept all of it right away:
+    auto broadcast(WebSocketMessage* msg) -> int {
+      uint8_t frame[10];
+      uint size = frame_header(frame, msg->opcode, msg->bytes.size(), false);
+
+      int count = 0;
+      for (uint i : range(clients->GetSize())) {
+        auto ws = *(WebSocket**)clients->At(i);
+        if (!ws || !*ws) continue;
+        ws->sendFramed(frame, size, msg->bytes.data(), msg->bytes.size());
+        count++;
+      }
+      return count;
+    }
   };
 
   auto create_web_socket_server(string *uri) -> WebSocketServer* {
@@ -1182,6 +2091,10 @@ namespace Net {
   }
 }
 
+auto deliverNetEvents(uint vcounter) -> void {
+  Net::reactor.deliver(vcounter);
+}
+
 auto RegisterNet(asIScriptEngine *e) -> void {
   int r;
 
@@ -1213,6 +2126,12 @@ auto RegisterNet(asIScriptEngine *e) -> void {
   r = e->RegisterObjectMethod("Socket", "int send(int offs, int size, array<uint8> &inout buffer)", asMETHOD(Net::Socket, send), asCALL_THISCALL); assert( r >= 0 );
   r = e->RegisterObjectMethod("Socket", "int recvfrom(int offs, int size, array<uint8> &inout buffer)", asMETHOD(Net::Socket, recvfrom), asCALL_THISCALL); assert( r >= 0 );
   r = e->RegisterObjectMethod("Socket", "int sendto(int offs, int size, array<uint8> &inout buffer, const Address@ addr)", asMETHOD(Net::Socket, sendto), asCALL_THISCALL); assert( r >= 0 );
+  r = e->RegisterObjectMethod("Socket", "uint get_available() property", asMETHOD(Net::Socket, get_available), asCALL_THISCALL); assert( r >= 0 );
+
+  // ready events from the I/O reactor:
+  r = e->RegisterFuncdef("void ReadyCallback(array<Socket@>@ sockets)"); assert(r >= 0);
+  r = e->RegisterGlobalFunction("array<Socket@>@ ready()", asFUNCTION(Net::ready), asCALL_CDECL); assert(r >= 0);
+  r = e->RegisterGlobalFunction("void on_ready(ReadyCallback@ cb)", asFUNCTION(Net::on_ready), asCALL_CDECL); assert(r >= 0);
 
   r = e->RegisterObjectType("WebSocketMessage", 0, asOBJ_REF); assert(r >= 0);
   r = e->RegisterObjectBehaviour("WebSocketMessage", asBEHAVE_FACTORY, "WebSocketMessage@ f(uint8 opcode)", asFUNCTION(Net::create_web_socket_message), asCALL_CDECL); assert(r >= 0);
@@ -1229,7 +2148,7 @@ auto RegisterNet(asIScriptEngine *e) -> void {
   r = e->RegisterObjectBehaviour("WebSocket", asBEHAVE_ADDREF, "void f()", asMETHOD(Net::WebSocket, addRef), asCALL_THISCALL); assert( r >= 0 );
   r = e->RegisterObjectBehaviour("WebSocket", asBEHAVE_RELEASE, "void f()", asMETHOD(Net::WebSocket, release), asCALL_THISCALL); assert( r >= 0 );
   r = e->RegisterObjectMethod("WebSocket", "WebSocketMessage@ process()", asMETHOD(Net::WebSocket, process), asCALL_THISCALL); assert( r >= 0 );
-  r = e->RegisterObjectMethod("WebSocket", "void send(WebSocketMessage@ msg)", asMETHOD(Net::WebSocket, send), asCALL_THISCALL); assert( r >= 0 );
+  r = e->RegisterObjectMethod("WebSocket", "void send(WebSocketMessage@+ msg)", asMETHOD(Net::WebSocket, send), asCALL_THISCALL); assert( r >= 0 );
   r = e->RegisterObjectMethod("WebSocket", "bool get_is_valid() property", asMETHOD(Net::WebSocket, operator bool), asCALL_THISCALL); assert( r >= 0 );
 
   r = e->RegisterObjectType("WebSocketHandshaker", 0, asOBJ_REF); assert(r >= 0);
@@ -1245,4 +2164,12 @@ auto RegisterNet(asIScriptEngine *e) -> void {
   r = e->RegisterObjectBehaviour("WebSocketServer", asBEHAVE_RELEASE, "void f()", asMETHOD(Net::WebSocketServer, release), asCALL_THISCALL); assert( r >= 0 );
   r = e->RegisterObjectMethod("WebSocketServer", "array<WebSocket@> &get_clients() property", asMETHOD(Net::WebSocketServer, get_clients), asCALL_THISCALL); assert( r >= 0 );
   r = e->RegisterObjectMethod("WebSocketServer", "int process()", asMETHOD(Net::WebSocketServer, process), asCALL_THISCALL); assert( r >= 0 );
+  r = e->RegisterObjectMethod("WebSocketServer", "int broadcast(WebSocketMessage@+ msg)", asMETHOD(Net::WebSocketServer, broadcast), asCALL_THISCALL); assert( r >= 0 );
+
+  r = e->RegisterObjectType("WebSocketClient", 0, asOBJ_REF); assert(r >= 0);
+  r = e->RegisterObjectBehaviour("WebSocketClient", asBEHAVE_FACTORY, "WebSocketClient@ f(string &in uri)", asFUNCTION(Net::create_web_socket_client), asCALL_CDECL); assert(r >= 0);
+  r = e->RegisterObjectBehaviour("WebSocketClient", asBEHAVE_ADDREF, "void f()", asMETHOD(Net::WebSocketClient, addRef), asCALL_THISCALL); assert( r >= 0 );
+  r = e->RegisterObjectBehaviour("WebSocketClient", asBEHAVE_RELEASE, "void f()", asMETHOD(Net::WebSocketClient, release), asCALL_THISCALL); assert( r >= 0 );
+  r = e->RegisterObjectMethod("WebSocketClient", "bool get_is_valid() property", asMETHOD(Net::WebSocketClient, operator bool), asCALL_THISCALL); assert( r >= 0 );
+  r = e->RegisterObjectMethod("WebSocketClient", "WebSocket@ process()", asMETHOD(Net::WebSocketClient, process), asCALL_THISCALL); assert( r >= 0 );
 }
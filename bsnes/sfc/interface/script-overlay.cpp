@@ -0,0 +1,255 @@
+// retained overlay: scripts draw into persistent ppu::Layer bitmaps, and the host composites every visible layer onto
+// the frame after post_frame(), just before it is handed to the video driver. Layers only change when a script draws
+// into them, so a static HUD costs no script time per frame. Each layer keeps a copy of its bitmap scaled to the frame
+// and mapped through its luma; that copy is rebuilt only when the layer or the frame size changed, which leaves a
+// row-wise blend_row() per frame.
+struct OverlayLayer;
+
+struct Overlay {
+  vector<OverlayLayer*> layers;  // in z order once sorted
+  bool sorted = true;
+
+  auto composite(uint16 *output, uint pitch, uint width, uint height) -> void;
+} overlay;
+
+struct OverlayLayer {
+  // pixels with bit 15 set are transparent, as with ppu::frame.blit():
+  static constexpr uint16 Transparent = 0x8000u;
+
+  int ref = 1;
+  auto addRef() -> void { ref++; }
+  auto release() -> void { if (--ref == 0) delete this; }
+
+  const int width;
+  const int height;
+  vector<uint16> pixels;
+
+  // placement and compositing, in the coordinates of ppu::frame at its default scale and y_offset:
+  int x = 0;
+  int y = 0;
+  int z = 0;
+  bool visible = true;
+  PostFrame::draw_op_t draw_op = PostFrame::op_solid;
+  uint8 alpha = 31;
+  uint8 luma = 15;
+
+  auto get_z() -> int { return z; }
+  auto set_z(int z_p) -> void { z = z_p; overlay.sorted = false; }
+  auto get_alpha() -> uint8 { return alpha; }
+  auto set_alpha(uint8 alpha_p) -> void { alpha = uclamp<5>(alpha_p); }
+  auto get_luma() -> uint8 { return luma; }
+  auto set_luma(uint8 luma_p) -> void { luma = uclamp<4>(luma_p); dirty = true; }
+
+  // drawing state:
+  uint16 color = 0x7fff;
+  auto get_color() -> uint16 { return color; }
+  auto set_color(uint16 color_p) -> void { color = uclamp<15>(color_p); }
+  bool text_shadow = false;
+
+  // copy of the layer scaled to the frame and mapped through luma:
+  bool dirty = true;
+  vector<uint16> scaled;
+  uint scaledWidth = 0;
+  uint scaledHeight = 0;
+  uint x_mult = 0;
+  uint y_mult = 0;
+
+  OverlayLayer(int width, int height) : width(width), height(height) {
+    pixels.resize(width * height);
+    for (auto &pixel : pixels) pixel = Transparent;
+    overlay.layers.append(this);
+    overlay.sorted = false;
+  }
+
+  ~OverlayLayer() {
+    if (auto index = overlay.layers.find(this)) overlay.layers.remove(*index);
+  }
+
+  static auto create(int width, int height) -> OverlayLayer* {
+    if (width <= 0 || height <= 0 || width > 1024 || height > 1024) {
+      asGetActiveContext()->SetException("layer size must be between 1x1 and 1024x1024", true);
+      return nullptr;
+    }
+    return new OverlayLayer(width, height);
+  }
+
+  auto get_width() -> int { return width; }
+  auto get_height() -> int { return height; }
+
+  // fills the clipped rectangle with a raw value:
+  auto set(int lx, int ty, int w, int h, uint16 value) -> void {
+    int x0 = max(lx, 0), x1 = min(lx + w, width);
+    int y0 = max(ty, 0), y1 = min(ty + h, height);
+    if (x0 >= x1 || y0 >= y1) return;
+    for (int py = y0; py < y1; py++) {
+      auto row = pixels.data() + py * width;
+      for (int px = x0; px < x1; px++) row[px] = value;
+    }
+    dirty = true;
+  }
+
+  auto clear() -> void { set(0, 0, width, height, Transparent); }
+  auto erase(int lx, int ty, int w, int h) -> void { set(lx, ty, w, h, Transparent); }
+  auto pixel(int px, int py) -> void { set(px, py, 1, 1, color); }
+  auto hline(int lx, int ty, int w) -> void { set(lx, ty, w, 1, color); }
+  auto vline(int lx, int ty, int h) -> void { set(lx, ty, 1, h, color); }
+  auto fill(int lx, int ty, int w, int h) -> void { set(lx, ty, w, h, color); }
+
+  auto rect(int lx, int ty, int w, int h) -> void {
+    hline(lx, ty, w);
+    hline(lx, ty + h - 1, w);
+    vline(lx, ty + 1, h - 2);
+    vline(lx + w - 1, ty + 1, h - 2);
+  }
+
+  auto get_pixel(int px, int py) -> uint16 {
+    if (px < 0 || py < 0 || px >= width || py >= height) return 0xffff;
+    return pixels[py * width + px];
+  }
+
+  // copies a w*h bitmap into the layer, including its transparent pixels:
+  auto blit(int lx, int ty, int w, int h, const CScriptArray *source) -> void {
+    if (source == nullptr) {
+      asGetActiveContext()->SetException("pixels array cannot be null", true);
+      return;
+    }
+    if (source->GetElementTypeId() != asTYPEID_UINT16) {
+      asGetActiveContext()->SetException("pixels array must be uint16[]", true);
+      return;
+    }
+    if (w <= 0 || h <= 0) return;
+    if (source->GetSize() < (uint64)w * h) {
+      asGetActiveContext()->SetException("pixels array must have at least w*h elements", true);
+      return;
+    }
+
+    int x0 = max(lx, 0), x1 = min(lx + w, width);
+    int y0 = max(ty, 0), y1 = min(ty + h, height);
+    if (x0 >= x1 || y0 >= y1) return;
+    auto data = static_cast<const uint16 *>(source->At(0));
+    for (int py = y0; py < y1; py++) {
+      memory::copy<uint16>(pixels.data() + py * width + x0, data + (py - ty) * w + (x0 - lx), x1 - x0);
+    }
+    dirty = true;
+  }
+
+  // draws ASCII text with the 8x8 font; returns the number of characters drawn:
+  auto text(int lx, int ty, const string *msg) -> int {
+    int len = 0;
+    for (const char *c = msg->data(); *c; c++) {
+      if (*c < 0x20 || *c > 0x7f) continue;
+      auto glyph = PixelFonts::font8x8_basic[*c - 0x20];
+      for (int i = 0; i < 8; i++) {
+        uint8 row = glyph[i];
+        uint8 below = i < 7 ? glyph[i + 1] : 0;
+        for (int j = 0; j < 8; j++) {
+          uint8 m = 0x80u >> j;
+          if (!(row & m)) continue;
+          if (text_shadow && !(below & (m >> 1u))) set(lx + j + 1, ty + i + 1, 1, 1, 0x0000);
+          set(lx + j, ty + i, 1, 1, color);
+        }
+      }
+      lx += 8;
+      len++;
+    }
+    return len;
+  }
+
+  // rebuilds the scaled copy if the layer or the frame multipliers changed:
+  auto prepare(uint xm, uint ym) -> void {
+    if (!dirty && xm == x_mult && ym == y_mult) return;
+    x_mult = xm, y_mult = ym;
+    scaledWidth = width * xm;
+    scaledHeight = height * ym;
+    scaled.reallocate(scaledWidth * scaledHeight);
+
+    auto lumaLookup = ppuAccess.lightTable_lookup(luma);
+    for (int py = 0; py < height; py++) {
+      auto source = pixels.data() + py * width;
+      auto target = scaled.data() + py * ym * scaledWidth;
+      for (int px = 0; px < width; px++) {
+        uint16 c = source[px];
+        if (!(c & Transparent)) c = lumaLookup[c];
+        for (uint n = 0; n < xm; n++) target[px * xm + n] = c;
+      }
+      for (uint n = 1; n < ym; n++) memory::copy<uint16>(target + n * scaledWidth, target, scaledWidth);
+    }
+    dirty = false;
+  }
+};
+
+auto Overlay::composite(uint16 *output, uint pitch, uint width, uint height) -> void {
+  if (!layers) return;
+
+  if (!sorted) {
+    // stable, so that layers with the same z are drawn in creation order:
+    for (uint i = 1; i < layers.size(); i++) {
+      for (uint j = i; j > 0 && layers[j - 1]->z > layers[j]->z; j--) std::swap(layers[j - 1], layers[j]);
+    }
+    sorted = true;
+  }
+
+  uint xm = max(width / 256u, 1u);
+  uint ym = max(height / 240u, 1u);
+  for (auto layer : layers) {
+    if (!layer->visible) continue;
+    layer->prepare(xm, ym);
+
+    // same mapping as ppu::frame with x_scale = y_scale = 2 and y_offset = 16:
+    int fx = layer->x * (int)xm;
+    int fy = (layer->y * 2 + 16) * (int)ym / 2;
+    int x0 = max(fx, 0), x1 = min(fx + (int)layer->scaledWidth, (int)width);
+    int y0 = max(fy, 0), y1 = min(fy + (int)layer->scaledHeight, (int)height);
+    if (x0 >= x1 || y0 >= y1) continue;
+
+    for (int y = y0; y < y1; y++) {
+      auto source = layer->scaled.data() + (y - fy) * layer->scaledWidth + (x0 - fx);
+      PostFrame::blend_row(output + y * pitch + x0, source, x1 - x0, layer->draw_op, layer->alpha);
+    }
+  }
+}
+
+auto compositeOverlay(uint16 *output, uint pitch, uint width, uint height) -> void {
+  overlay.composite(output, pitch, width, height);
+}
+
+auto RegisterPPUOverlay(asIScriptEngine *e) -> void {
+  int r;
+
+  // assumes current default namespace is 'ppu'
+
+  r = e->RegisterObjectType("Layer", 0, asOBJ_REF); assert(r >= 0);
+  r = e->RegisterObjectBehaviour("Layer", asBEHAVE_FACTORY, "Layer@ f(int width, int height)", asFUNCTION(OverlayLayer::create), asCALL_CDECL); assert(r >= 0);
+  r = e->RegisterObjectBehaviour("Layer", asBEHAVE_ADDREF, "void f()", asMETHOD(OverlayLayer, addRef), asCALL_THISCALL); assert(r >= 0);
+  r = e->RegisterObjectBehaviour("Layer", asBEHAVE_RELEASE, "void f()", asMETHOD(OverlayLayer, release), asCALL_THISCALL); assert(r >= 0);
+
+  r = e->RegisterObjectMethod("Layer", "int get_width() property", asMETHOD(OverlayLayer, get_width), asCALL_THISCALL); assert(r >= 0);
+  r = e->RegisterObjectMethod("Layer", "int get_height() property", asMETHOD(OverlayLayer, get_height), asCALL_THISCALL); assert(r >= 0);
+
+  // placement and compositing:
+  r = e->RegisterObjectProperty("Layer", "int x", asOFFSET(OverlayLayer, x)); assert(r >= 0);
+  r = e->RegisterObjectProperty("Layer", "int y", asOFFSET(OverlayLayer, y)); assert(r >= 0);
+  r = e->RegisterObjectMethod("Layer", "int get_z() property", asMETHOD(OverlayLayer, get_z), asCALL_THISCALL); assert(r >= 0);
+  r = e->RegisterObjectMethod("Layer", "void set_z(int z) property", asMETHOD(OverlayLayer, set_z), asCALL_THISCALL); assert(r >= 0);
+  r = e->RegisterObjectProperty("Layer", "bool visible", asOFFSET(OverlayLayer, visible)); assert(r >= 0);
+  r = e->RegisterObjectProperty("Layer", "draw_op draw_op", asOFFSET(OverlayLayer, draw_op)); assert(r >= 0);
+  r = e->RegisterObjectMethod("Layer", "uint8 get_alpha() property", asMETHOD(OverlayLayer, get_alpha), asCALL_THISCALL); assert(r >= 0);
+  r = e->RegisterObjectMethod("Layer", "void set_alpha(uint8 alpha) property", asMETHOD(OverlayLayer, set_alpha), asCALL_THISCALL); assert(r >= 0);
+  r = e->RegisterObjectMethod("Layer", "uint8 get_luma() property", asMETHOD(OverlayLayer, get_luma), asCALL_THISCALL); assert(r >= 0);
+  r = e->RegisterObjectMethod("Layer", "void set_luma(uint8 luma) property", asMETHOD(OverlayLayer, set_luma), asCALL_THISCALL); assert(r >= 0);
+
+  // drawing into the layer:
+  r = e->RegisterObjectMethod("Layer", "uint16 get_color() property", asMETHOD(OverlayLayer, get_color), asCALL_THISCALL); assert(r >= 0);
+  r = e->RegisterObjectMethod("Layer", "void set_color(uint16 color) property", asMETHOD(OverlayLayer, set_color), asCALL_THISCALL); assert(r >= 0);
+  r = e->RegisterObjectProperty("Layer", "bool text_shadow", asOFFSET(OverlayLayer, text_shadow)); assert(r >= 0);
+  r = e->RegisterObjectMethod("Layer", "void clear()", asMETHOD(OverlayLayer, clear), asCALL_THISCALL); assert(r >= 0);
+  r = e->RegisterObjectMethod("Layer", "void erase(int x, int y, int w, int h)", asMETHOD(OverlayLayer, erase), asCALL_THISCALL); assert(r >= 0);
+  r = e->RegisterObjectMethod("Layer", "uint16 read_pixel(int x, int y)", asMETHOD(OverlayLayer, get_pixel), asCALL_THISCALL); assert(r >= 0);
+  r = e->RegisterObjectMethod("Layer", "void pixel(int x, int y)", asMETHOD(OverlayLayer, pixel), asCALL_THISCALL); assert(r >= 0);
+  r = e->RegisterObjectMethod("Layer", "void hline(int lx, int ty, int w)", asMETHOD(OverlayLayer, hline), asCALL_THISCALL); assert(r >= 0);
+  r = e->RegisterObjectMethod("Layer", "void vline(int lx, int ty, int h)", asMETHOD(OverlayLayer, vline), asCALL_THISCALL); assert(r >= 0);
+  r = e->RegisterObjectMethod("Layer", "void rect(int x, int y, int w, int h)", asMETHOD(OverlayLayer, rect), asCALL_THISCALL); assert(r >= 0);
+  r = e->RegisterObjectMethod("Layer", "void fill(int x, int y, int w, int h)", asMETHOD(OverlayLayer, fill), asCALL_THISCALL); assert(r >= 0);
+  r = e->RegisterObjectMethod("Layer", "void blit(int x, int y, int w, int h, const array<uint16> &in pixels)", asMETHOD(OverlayLayer, blit), asCALL_THISCALL); assert(r >= 0);
+  r = e->RegisterObjectMethod("Layer", "int text(int x, int y, const string &in text)", asMETHOD(OverlayLayer, text), asCALL_THISCALL); assert(r >= 0);
+}
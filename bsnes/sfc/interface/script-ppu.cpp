@@ -225,6 +225,131 @@ struct PPUAccess {
   }
 } ppuAccess;
 
+// script callbacks timed to a scanline (ppu::on_scanline) or to an H/V position (ppu::on_hv), sorted by position.
+// `lines[v]` is the index of the first event on or after scanline v, so the CPU only looks at the events of the current
+// scanline and does no work on scanlines without any:
+struct RasterEvents {
+  enum : uint { Lines = 312, Dots = 340 };
+
+  struct event_t {
+    uint16 v;
+    uint16 h;    // PPU dot; 0 for scanline events
+    bool   hv;   // registered with on_hv(), which passes h to the callback
+    asIScriptFunction *cb;
+
+    auto position() const -> uint { return v << 16 | h << 1 | hv; }
+  };
+  vector<event_t> events;
+  uint lines[Lines + 1] = {};
+
+  // events of the current scanline that are yet to run:
+  uint next = 0;
+  uint end = 0;
+
+  static auto key(const event_t &event) -> string {
+    return {event.hv ? "hv:" : "scanline:", event.v, ",", event.h};
+  }
+
+  auto reindex() -> void {
+    uint i = 0;
+    for (uint v : range(Lines + 1)) {
+      while (i < events.size() && events[i].v < v) i++;
+      lines[v] = i;
+    }
+    // a change made by a callback takes effect on the next scanline:
+    next = end = 0;
+    ::SuperFamicom::script.rasterEvents = (bool)events;
+  }
+
+  auto add(const event_t &event) -> void {
+    remove(event);
+    uint i = 0;
+    while (i < events.size() && events[i].position() < event.position()) i++;
+    event.cb->AddRef();
+    events.insert(i, event);
+    reindex();
+  }
+
+  auto remove(const event_t &event) -> void {
+    for (uint i : range(events.size())) {
+      if (events[i].position() != event.position()) continue;
+      events[i].cb->Release();
+      events.remove(i);
+      reindex();
+      return;
+    }
+  }
+
+  auto reset() -> void {
+    for (auto &event : events) event.cb->Release();
+    events.reset();
+    reindex();
+  }
+
+  // starts a new scanline; returns the hcounter of its first pending event, or ~0 if there is none:
+  auto scanline(uint vcounter, uint hcounter) -> uint {
+    if (vcounter >= Lines) return next = end = 0, ~0u;
+    next = lines[vcounter];
+    end = lines[vcounter + 1];
+    return deliver(hcounter);
+  }
+
+  // runs the events of the current scanline up to hcounter; returns the hcounter of the next one, or ~0 if there is none:
+  auto deliver(uint hcounter) -> uint {
+    while (next < end && events[next].h * 4u <= hcounter) {
+      auto event = events[next++];
+      // the callback may remove itself:
+      event.cb->AddRef();
+      executeCallback(event.cb, [&](asIScriptContext *ctx) {
+        if (event.hv) {
+          ctx->SetArgDWord(0, event.h);
+          ctx->SetArgDWord(1, event.v);
+        } else {
+          ctx->SetArgDWord(0, event.v);
+        }
+      });
+      event.cb->Release();
+    }
+    return next < end ? events[next].h * 4u : ~0u;
+  }
+} rasterEvents;
+
+static auto on_position(uint h, uint v, bool hv, asIScriptFunction *cb) -> void {
+  if (v >= RasterEvents::Lines || h >= RasterEvents::Dots) {
+    asGetActiveContext()->SetException(hv ? "h or v out of range" : "scanline out of range", true);
+    return;
+  }
+
+  RasterEvents::event_t event{uint16(v), uint16(h), hv, cb};
+  if (cb) {
+    rasterEvents.add(event);
+    hooks.track(cb, RasterEvents::key(event), [=] { rasterEvents.remove(event); });
+  } else {
+    rasterEvents.remove(event);
+    hooks.untrack(RasterEvents::key(event));
+  }
+}
+
+static auto on_scanline(uint v, asIScriptFunction *cb) -> void {
+  on_position(0, v, false, cb);
+}
+
+static auto on_hv(uint h, uint v, asIScriptFunction *cb) -> void {
+  on_position(h, v, true, cb);
+}
+
+auto deliverScanlineEvents(uint vcounter, uint hcounter) -> uint {
+  return rasterEvents.scanline(vcounter, hcounter);
+}
+
+auto deliverRasterEvents(uint hcounter) -> uint {
+  return rasterEvents.deliver(hcounter);
+}
+
+auto resetRasterEvents() -> void {
+  rasterEvents.reset();
+}
+
 auto RegisterPPU(asIScriptEngine *e) -> void {
   int r;
 
@@ -247,6 +372,11 @@ auto RegisterPPU(asIScriptEngine *e) -> void {
   r = e->RegisterGlobalFunction("uint8 sprite_height(uint8 baseSize, uint8 size)", asFUNCTION(PPUAccess::ppu_sprite_height), asCALL_CDECL); assert(r >= 0);
   r = e->RegisterGlobalFunction("uint8 sprite_base_size()", asFUNCTION(PPUAccess::ppu_sprite_base_size), asCALL_CDECL); assert(r >= 0);
 
+  r = e->RegisterFuncdef("void ScanlineCallback(uint v)"); assert(r >= 0);
+  r = e->RegisterFuncdef("void HVCallback(uint h, uint v)"); assert(r >= 0);
+  r = e->RegisterGlobalFunction("void on_scanline(uint v, ScanlineCallback@+ cb)", asFUNCTION(on_scanline), asCALL_CDECL); assert(r >= 0);
+  r = e->RegisterGlobalFunction("void on_hv(uint h, uint v, HVCallback@+ cb)", asFUNCTION(on_hv), asCALL_CDECL); assert(r >= 0);
+
   // define ppu::VRAM object type for opIndex convenience:
   r = e->RegisterObjectType("VRAM", 0, asOBJ_REF | asOBJ_NOHANDLE); assert(r >= 0);
   r = e->RegisterObjectMethod("VRAM", "uint16 opIndex(uint16 addr)", asMETHOD(PPUAccess, vram_read), asCALL_THISCALL); assert(r >= 0);
@@ -0,0 +1,165 @@
+// run-ahead emulates several frames ahead of the displayed one and then loads the state saved after the first frame
+// again, so every frame after that save is speculative and gets rolled back. Scripts would run once per emulated frame
+// and keep the side effects of frames that never happened. Each module picks how it is treated with
+// run_ahead::policy:
+//   run      - called on every frame, speculative or not (default; scripts behave as without run-ahead)
+//   skip     - not called during speculative frames, except for post_frame() which draws the displayed frame
+//   rollback - called on every frame; its global variables are saved along with the run-ahead state and restored when
+//              that state is loaded
+struct RunAhead {
+  enum policy_t : int { run, skip, rollback };
+
+  // module user data slot holding its policy:
+  static constexpr asPWORD PolicyUserData = 0x52484144;  // 'RHAD'
+
+  static auto policyOf(asIScriptModule *module) -> policy_t {
+    return module ? (policy_t)(uintptr_t)module->GetUserData(PolicyUserData) : run;
+  }
+
+  static auto get_policy() -> policy_t {
+    return policyOf(activeModule());
+  }
+
+  static auto set_policy(policy_t policy) -> void {
+    if (auto module = activeModule()) module->SetUserData((void *)(uintptr_t)policy, PolicyUserData);
+  }
+
+  static auto get_speculative() -> bool {
+    return ::SuperFamicom::script.speculative;
+  }
+
+  // saved global variables of each rollback module, in ::SuperFamicom::script.modules order:
+  vector<vector<uint8_t>> snapshots;
+  uint offset = 0;
+
+  // writes (Save) or reads back (!Save) a value in place. Object handles are skipped, so rolled back objects keep their
+  // identity; strings, arrays and script objects held by value are visited recursively:
+  template<bool Save>
+  auto visit(asIScriptEngine *engine, vector<uint8_t> &buffer, void *ptr, int typeId) -> bool {
+    if (!ptr || (typeId & asTYPEID_OBJHANDLE)) return true;
+
+    if (!(typeId & asTYPEID_MASK_OBJECT)) {
+      // primitives and enums:
+      return bytes<Save>(buffer, ptr, engine->GetSizeOfPrimitiveType(typeId));
+    }
+
+    if (typeId & asTYPEID_SCRIPTOBJECT) {
+      auto object = (asIScriptObject *)ptr;
+      for (uint i : range(object->GetPropertyCount())) {
+        if (!visit<Save>(engine, buffer, object->GetAddressOfProperty(i), object->GetPropertyTypeId(i))) return false;
+      }
+      return true;
+    }
+
+    auto type = engine->GetTypeInfoById(typeId);
+    if (!type) return true;
+    string name = type->GetName();
+
+    if (name == "string") {
+      auto &text = *(string *)ptr;
+      uint size = text.size();
+      if (!bytes<Save>(buffer, &size, sizeof(size))) return false;
+      if constexpr(!Save) text.resize(size);
+      return bytes<Save>(buffer, text.get(), size);
+    }
+
+    if (name == "array") {
+      auto array = (CScriptArray *)ptr;
+      // arrays of handles would need their references counted; leave them alone:
+      if (array->GetElementTypeId() & asTYPEID_OBJHANDLE) return true;
+      uint size = array->GetSize();
+      if (!bytes<Save>(buffer, &size, sizeof(size))) return false;
+      if constexpr(!Save) array->Resize(size);
+      for (uint i : range(size)) {
+        if (!visit<Save>(engine, buffer, array->At(i), array->GetElementTypeId())) return false;
+      }
+      return true;
+    }
+
+    // other registered types refer to emulator state, which is rolled back by the emulator itself:
+    return true;
+  }
+
+  template<bool Save>
+  auto bytes(vector<uint8_t> &buffer, void *data, uint size) -> bool {
+    if constexpr(Save) {
+      uint end = buffer.size();
+      buffer.resize(end + size);
+      memory::copy(buffer.data() + end, data, size);
+    } else {
+      if (offset + size > buffer.size()) return false;
+      memory::copy(data, buffer.data() + offset, size);
+      offset += size;
+    }
+    return true;
+  }
+
+  template<bool Save>
+  auto visitModule(asIScriptModule *module, vector<uint8_t> &buffer) -> bool {
+    auto engine = module->GetEngine();
+    offset = 0;
+    for (uint i : range(module->GetGlobalVarCount())) {
+      int typeId;
+      bool isConst;
+      if (module->GetGlobalVar(i, nullptr, nullptr, &typeId, &isConst) < 0 || isConst) continue;
+      if (!visit<Save>(engine, buffer, module->GetAddressOfGlobalVar(i), typeId)) return false;
+    }
+    return true;
+  }
+
+  // called when the run-ahead state is saved; every frame until it is loaded again is speculative:
+  auto save() -> void {
+    auto &script = ::SuperFamicom::script;
+    script.speculative = true;
+
+    snapshots.resize(script.modules.size());
+    for (uint n : range(script.modules.size())) {
+      auto &snapshot = snapshots[n];
+      snapshot.reallocate(0);
+      auto module = script.modules[n].module;
+      if (policyOf(module) != rollback) continue;
+      visitModule<true>(module, snapshot);
+    }
+  }
+
+  // called when the run-ahead state is loaded:
+  auto load() -> void {
+    auto &script = ::SuperFamicom::script;
+    script.speculative = false;
+
+    for (uint n : range(min(script.modules.size(), snapshots.size()))) {
+      auto module = script.modules[n].module;
+      if (policyOf(module) != rollback || !snapshots[n]) continue;
+      if (!visitModule<false>(module, snapshots[n])) {
+        platform->scriptMessage({"WARN module '", script.modules[n].name, "' could not be rolled back after run-ahead"});
+      }
+    }
+  }
+} runAhead;
+
+auto skipSpeculative(asIScriptFunction *func) -> bool {
+  return RunAhead::policyOf(moduleOf(func)) == RunAhead::skip;
+}
+
+auto runAheadSave() -> void {
+  runAhead.save();
+}
+
+auto runAheadLoad() -> void {
+  runAhead.load();
+}
+
+auto RegisterRunAhead(asIScriptEngine *e) -> void {
+  int r;
+
+  r = e->SetDefaultNamespace("run_ahead"); assert(r >= 0);
+
+  r = e->RegisterEnum("policy"); assert(r >= 0);
+  r = e->RegisterEnumValue("policy", "run", RunAhead::run); assert(r >= 0);
+  r = e->RegisterEnumValue("policy", "skip", RunAhead::skip); assert(r >= 0);
+  r = e->RegisterEnumValue("policy", "rollback", RunAhead::rollback); assert(r >= 0);
+
+  r = e->RegisterGlobalFunction("policy get_policy() property", asFUNCTION(RunAhead::get_policy), asCALL_CDECL); assert(r >= 0);
+  r = e->RegisterGlobalFunction("void set_policy(policy p) property", asFUNCTION(RunAhead::set_policy), asCALL_CDECL); assert(r >= 0);
+  r = e->RegisterGlobalFunction("bool get_speculative() property", asFUNCTION(RunAhead::get_speculative), asCALL_CDECL); assert(r >= 0);
+}
@@ -24,12 +24,16 @@ auto Bus::reduce(uint addr, uint mask) -> uint {
 }
 
 auto Bus::read(uint addr, uint8 data) -> uint8 {
-  return reader[lookup[addr]](target[addr], data);
+  data = reader[lookup[addr]](target[addr], data);
+  // [jsd] compare values are checked against what was read:
+  if(cheats) if(auto replace = cheats.find(addr, data)) return replace();
+  return data;
 }
 
 auto Bus::write(uint addr, uint8 data) -> void {
   // call interceptor before actual write takes place:
-  interceptor[interceptor_lookup[addr]](interceptor_target[addr], data);
+  uint bank = addr >> 16 & 0xff, offset = addr & 0xffff;
+  interceptor[interceptor_lookup[bank][offset]](interceptor_target[bank][offset], data);
   return writer[lookup[addr]](target[addr], data);
 }
 
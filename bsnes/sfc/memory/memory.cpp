@@ -2,14 +2,75 @@
 
 namespace SuperFamicom {
 
-bool Memory::GlobalWriteEnable = false;
-Bus bus;
+instance_local bool Memory::GlobalWriteEnable = false;
+SFC_GLOBAL(Bus, bus);
+
+// [jsd] shared read-only pages for banks without write interceptors:
+static uint8 interceptor_lookup_empty[0x10000];
+static uint32 interceptor_target_empty[0x10000];
+
+// [jsd] blocks handed out by SharedBlock::share(); a block is dropped from the list once it is written to:
+static std::mutex sharedBlocksMutex;
+static vector<std::weak_ptr<SharedBlock>> sharedBlocks;
+
+//takes ownership of data, which was allocated with new[]. if another block holds the same contents, data is released
+//and pointed to that block instead:
+auto SharedBlock::share(uint8*& data, uint size) -> std::shared_ptr<SharedBlock> {
+  std::lock_guard<std::mutex> lock(sharedBlocksMutex);
+  for(uint n = 0; n < sharedBlocks.size();) {
+    auto block = sharedBlocks[n].lock();
+    if(!block) {
+      sharedBlocks.remove(n);
+      continue;
+    }
+    if(block->size == size && memory::compare(block->data, data, size) == 0) {
+      delete[] data;
+      data = block->data;
+      return block;
+    }
+    n++;
+  }
+
+  auto block = std::make_shared<SharedBlock>();
+  block->data = data;
+  block->size = size;
+  sharedBlocks.append(block);
+  return block;
+}
+
+//releases the block and returns a copy of its contents that only the caller owns; the last owner keeps the data:
+auto SharedBlock::unshare(std::shared_ptr<SharedBlock>& block) -> uint8* {
+  std::lock_guard<std::mutex> lock(sharedBlocksMutex);
+  uint8* data = nullptr;
+  if(block.use_count() > 1) {
+    data = new uint8[block->size];
+    memory::copy(data, block->data, block->size);
+  } else {
+    for(uint n : range(sharedBlocks.size())) {
+      if(sharedBlocks[n].lock() != block) continue;
+      sharedBlocks.remove(n);
+      break;
+    }
+    data = block->data;
+    block->data = nullptr;
+  }
+  block.reset();
+  return data;
+}
+
+Bus::Bus() {
+  for(uint bank : range(256)) {
+    interceptor_lookup[bank] = interceptor_lookup_empty;
+    interceptor_target[bank] = interceptor_target_empty;
+  }
+}
 
 Bus::~Bus() {
-  if(lookup) delete[] lookup;
-  if(target) delete[] target;
-  if(interceptor_lookup) delete[] interceptor_lookup;
-  if(interceptor_target) delete[] interceptor_target;
+  if(!shared) delete[] lookup;
+  for(uint bank : range(256)) {
+    if(interceptor_lookup[bank] != interceptor_lookup_empty) delete[] interceptor_lookup[bank];
+    if(interceptor_target[bank] != interceptor_target_empty) delete[] interceptor_target[bank];
+  }
 }
 
 auto Bus::reset() -> void {
@@ -19,16 +80,17 @@ auto Bus::reset() -> void {
     counter[id] = 0;
   }
 
-  if(lookup) delete[] lookup;
-  if(target) delete[] target;
+  if(!shared) delete[] lookup;
+  shared.reset();
 
-  lookup = new uint8 [16 * 1024 * 1024]();
-  target = new uint32[16 * 1024 * 1024]();
+  lookup = new uint8[Tables]();
+  target = (uint32*)(lookup + 16 * 1024 * 1024);
 
   reader[0] = [](uint, uint8 data) -> uint8 { return data; };
   writer[0] = [](uint, uint8) -> void {};
 
   // [jsd]
+  cheats.reset();
   reset_interceptors();
 }
 
@@ -38,15 +100,36 @@ auto Bus::reset_interceptors() -> void {
     interceptor_counter[id] = 0;
   }
 
-  if(interceptor_lookup) delete[] interceptor_lookup;
-  if(interceptor_target) delete[] interceptor_target;
-
-  interceptor_lookup = new uint8 [16 * 1024 * 1024]();
-  interceptor_target = new uint32 [16 * 1024 * 1024]();
+  // release only the banks that had interceptors:
+  for(uint bank : range(256)) {
+    if(interceptor_lookup[bank] != interceptor_lookup_empty) delete[] interceptor_lookup[bank];
+    if(interceptor_target[bank] != interceptor_target_empty) delete[] interceptor_target[bank];
+    interceptor_lookup[bank] = interceptor_lookup_empty;
+    interceptor_target[bank] = interceptor_target_empty;
+  }
 
   interceptor[0] = [](uint, uint8) -> void {};
 }
 
+//removes whatever is left of an interceptor that later interceptors have not replaced:
+auto Bus::remove_interceptor(uint id) -> void {
+  if(!id || !interceptor_counter[id]) return;
+
+  for(uint bank : range(256)) {
+    auto lookupPage = interceptor_lookup[bank];
+    if(lookupPage == interceptor_lookup_empty) continue;
+    auto targetPage = interceptor_target[bank];
+    for(uint addr : range(0x10000)) {
+      if(lookupPage[addr] != id) continue;
+      lookupPage[addr] = 0;
+      targetPage[addr] = 0;
+    }
+  }
+
+  interceptor[id].reset();
+  interceptor_counter[id] = 0;
+}
+
 auto Bus::map(
   const function<uint8 (uint, uint8)>& read,
   const function<void  (uint, uint8)>& write,
@@ -56,6 +139,7 @@ auto Bus::map(
   while(counter[id]) {
     if(++id >= 256) return print("SFC error: bus map exhausted\n"), 0;
   }
+  if(shared) unshare();
 
   reader[id] = read;
   writer[id] = write;
@@ -95,6 +179,8 @@ auto Bus::map(
 }
 
 auto Bus::unmap(const string& addr) -> void {
+  if(shared) unshare();
+
   auto p = addr.split(":", 1L);
   auto banks = p(0).split(",");
   auto addrs = p(1).split(",");
@@ -123,6 +209,18 @@ auto Bus::unmap(const string& addr) -> void {
   }
 }
 
+//[jsd] called once the system is powered; consoles that mapped their memory the same way share the lookup tables:
+auto Bus::share() -> void {
+  if(shared || !lookup) return;
+  shared = SharedBlock::share(lookup, Tables);
+  target = (uint32*)(lookup + 16 * 1024 * 1024);
+}
+
+auto Bus::unshare() -> void {
+  lookup = SharedBlock::unshare(shared);
+  target = (uint32*)(lookup + 16 * 1024 * 1024);
+}
+
 auto Bus::add_write_interceptor(
   const string& addr, uint size,
   const function<void  (uint, uint8)> &intercept
@@ -150,16 +248,24 @@ auto Bus::add_write_interceptor(
       uint addrHi = addrRange(1, addrRange(0)).hex();
 
       for(uint bank = bankLo; bank <= bankHi; bank++) {
+        // allocate the bank's pages on first use:
+        if(interceptor_lookup[bank] == interceptor_lookup_empty) {
+          interceptor_lookup[bank] = new uint8 [0x10000]();
+          interceptor_target[bank] = new uint32[0x10000]();
+        }
+        auto lookupPage = interceptor_lookup[bank];
+        auto targetPage = interceptor_target[bank];
+
         for(uint addr = addrLo; addr <= addrHi; addr++) {
-          uint pid = interceptor_lookup[bank << 16u | addr];
+          uint pid = lookupPage[addr];
           if(pid && --interceptor_counter[pid] == 0) {
             interceptor[pid].reset();
           }
 
           uint offset = reduce(bank << 16u | addr, mask);
           if(size) offset = base + mirror(offset, size - base);
-          interceptor_lookup[bank << 16u | addr] = id;
-          interceptor_target[bank << 16u | addr] = offset;
+          lookupPage[addr] = id;
+          targetPage[addr] = offset;
           interceptor_counter[id]++;
         }
       }
@@ -1,11 +1,12 @@
 struct Memory {
-  static bool GlobalWriteEnable;
+  static instance_local bool GlobalWriteEnable;
 
   virtual ~Memory() { reset(); }
   inline explicit operator bool() const { return size() > 0; }
 
   virtual auto reset() -> void {}
   virtual auto allocate(uint, uint8 = 0xff) -> void {}
+  virtual auto share() -> void {}
 
   virtual auto data() -> uint8* = 0;
   virtual auto size() const -> uint = 0;
@@ -16,6 +17,18 @@ struct Memory {
   uint id = 0;
 };
 
+//[jsd] contents that are the same for several consoles in one process, such as ROM and the bus lookup tables, are kept
+//once and shared until one of the consoles writes to them (see Instance):
+struct SharedBlock {
+  ~SharedBlock() { delete[] data; }
+
+  static auto share(uint8*& data, uint size) -> std::shared_ptr<SharedBlock>;
+  static auto unshare(std::shared_ptr<SharedBlock>& block) -> uint8*;
+
+  uint8* data = nullptr;
+  uint size = 0;
+};
+
 #include "readable.hpp"
 #include "writable.hpp"
 #include "protectable.hpp"
@@ -24,6 +37,7 @@ struct Bus {
   alwaysinline static auto mirror(uint address, uint size) -> uint;
   alwaysinline static auto reduce(uint address, uint mask) -> uint;
 
+  Bus();
   ~Bus();
 
   alwaysinline auto read(uint address, uint8 data = 0) -> uint8;
@@ -36,6 +50,7 @@ struct Bus {
     const string& address, uint size = 0, uint base = 0, uint mask = 0
   ) -> uint;
   auto unmap(const string& address) -> void;
+  auto share() -> void;
 
   // [jsd] for intercepting writes:
   alwaysinline auto write_no_intercept(uint addr, uint8 data) -> void;
@@ -43,21 +58,31 @@ struct Bus {
     const string& addr, uint size,
     const function<void  (uint, uint8)> &intercept
   ) -> uint;
+  auto remove_interceptor(uint id) -> void;
   auto reset_interceptors() -> void;
 
+  // [jsd] codes that replace what is read from their address, assigned by Interface::cheats():
+  Cheat cheats;
+
 private:
+  //both tables are one allocation of Tables bytes, which share() may hand to other consoles:
+  enum : uint { Tables = 16 * 1024 * 1024 * (sizeof(uint8) + sizeof(uint32)) };
+  auto unshare() -> void;
+
   uint8* lookup = nullptr;
   uint32* target = nullptr;
+  std::shared_ptr<SharedBlock> shared;
 
   function<uint8 (uint, uint8)> reader[256];
   function<void  (uint, uint8)> writer[256];
   uint counter[256];
 
-  // [jsd] for intercepting writes:
-  uint8* interceptor_lookup = nullptr;
-  uint32* interceptor_target = nullptr;
+  // [jsd] for intercepting writes; paged by bank so that only banks with interceptors are allocated.
+  // unallocated banks point to shared all-zero pages which select the no-op interceptor[0]:
+  uint8* interceptor_lookup[256];
+  uint32* interceptor_target[256];
   function<void  (uint, uint8)> interceptor[256];
   uint interceptor_counter[256];
 };
 
-extern Bus bus;
+SFC_EXTERN(Bus, bus);
@@ -1,13 +1,14 @@
 struct ReadableMemory : Memory {
   inline auto reset() -> void override {
-    delete[] self.data;
+    if(!self.shared) delete[] self.data;
+    self.shared.reset();
     self.data = nullptr;
     self.size = 0;
   }
 
   inline auto allocate(uint size, uint8 fill = 0xff) -> void override {
-    if(self.size != size) {
-      delete[] self.data;
+    if(self.shared || self.size != size) {
+      reset();
       self.data = new uint8[self.size = size];
     }
     for(uint address : range(size)) {
@@ -15,6 +16,11 @@ struct ReadableMemory : Memory {
     }
   }
 
+  //[jsd] once loaded, the contents are shared with other consoles that loaded the same:
+  inline auto share() -> void override {
+    if(self.data && !self.shared) self.shared = SharedBlock::share(self.data, self.size);
+  }
+
   inline auto data() -> uint8* override {
     return self.data;
   }
@@ -29,6 +35,7 @@ struct ReadableMemory : Memory {
 
   inline auto write(uint address, uint8 data) -> void override {
     if(Memory::GlobalWriteEnable) {
+      if(self.shared) self.data = SharedBlock::unshare(self.shared);
       self.data[address] = data;
     }
   }
@@ -41,5 +48,6 @@ private:
   struct {
     uint8* data = nullptr;
     uint size = 0;
+    std::shared_ptr<SharedBlock> shared;
   } self;
 };
@@ -1,69 +1,8 @@
-uint PPU::Line::start = 0;
-uint PPU::Line::count = 0;
+instance_local uint PPU::Line::start = 0;
+instance_local uint PPU::Line::count = 0;
 
 auto PPU::Line::flush() -> void {
-#if 1
-  ppu.threadPool.wait();
-#else
-  if(Line::count) {
-    if(ppu.hdScale() > 1) cacheMode7HD();
-
-    auto fieldNumber = ppu.field();
-    std::function<void(PPU::Line&)> renderLine;
-    if (ppu.deinterlace()) {
-      if (!ppu.interlace()) {
-        //some games enable interlacing in 240p mode, just force these to even fields
-        renderLine = [](PPU::Line &line){
-          line.render(0);
-        };
-      } else {
-        //for actual interlaced frames, render both fields every farme for 480i -> 480p
-        renderLine = [](PPU::Line &line){
-          line.render(0);
-          line.render(1);
-        };
-      }
-    } else {
-      //standard 240p (progressive) and 480i (interlaced) rendering
-      renderLine = [fieldNumber](PPU::Line &line) {
-        line.render(fieldNumber);
-      };
-    }
-
-    if (Line::count < 8) {
-      for (uint y = 0; y < Line::count; y++) {
-        renderLine(ppu.lines[Line::start + y]);
-      }
-    } else {
-      //printf("%d\n", Line::count);
-
-      //#pragma omp parallel for if(Line::count >= 8)
-      for (uint y = 0; y < Line::count; y++) {
-        ppu.threadPool.enqueue(renderLine, std::ref(ppu.lines[Line::start + y]));
-#if 0
-        if (ppu.deinterlace()) {
-          if (!ppu.interlace()) {
-            //some games enable interlacing in 240p mode, just force these to even fields
-            ppu.lines[Line::start + y].render(0);
-          } else {
-            //for actual interlaced frames, render both fields every farme for 480i -> 480p
-            ppu.lines[Line::start + y].render(0);
-            ppu.lines[Line::start + y].render(1);
-          }
-        } else {
-          //standard 240p (progressive) and 480i (interlaced) rendering
-          ppu.lines[Line::start + y].render(ppu.field());
-        }
-#endif
-      }
-
-      ppu.threadPool.wait();
-    }
-
-    Line::start = 0;
-    Line::count = 0;
-  }
-#endif
+  ppu.renderer.wait();
 }
 
 auto PPU::Line::cache() -> void {
@@ -75,37 +14,15 @@ auto PPU::Line::cache() -> void {
     memcpy(&cgram, &ppu.cgram, sizeof(cgram));
   }
 
-#if 1
-  //if(ppu.hdScale() > 1) cacheMode7HD();
-
-  auto fieldNumber = ppu.field();
-  std::function<void(PPU::Line&)> renderLine;
-  if (ppu.deinterlace()) {
-    if (!ppu.interlace()) {
-      //some games enable interlacing in 240p mode, just force these to even fields
-      renderLine = [](PPU::Line &line){
-        line.render(0);
-      };
-    } else {
-      //for actual interlaced frames, render both fields every farme for 480i -> 480p
-      renderLine = [](PPU::Line &line){
-        line.render(0);
-        line.render(1);
-      };
-    }
-  } else {
-    //standard 240p (progressive) and 480i (interlaced) rendering
-    renderLine = [fieldNumber](PPU::Line &line) {
-      line.render(fieldNumber);
-    };
+  uint mode = ppu.field() ? Renderer::Field1 : Renderer::Field0;
+  if(ppu.deinterlace()) {
+    //some games enable interlacing in 240p mode, just force these to even fields.
+    //for actual interlaced frames, render both fields every frame for 480i -> 480p.
+    mode = !ppu.interlace() ? Renderer::Field0 : Renderer::BothFields;
   }
 
-  // queue a task to render this line:
-  ppu.threadPool.enqueue(renderLine, std::ref(ppu.lines[y]));
-#else
-  if(!Line::count) Line::start = y;
-  Line::count++;
-#endif
+  // queue a job to render this line:
+  ppu.renderer.submit(y, mode);
 }
 
 auto PPU::Line::render(bool fieldID) -> void {
@@ -3,14 +3,19 @@
 
 namespace SuperFamicom {
 
+#if defined(EMULATOR_INSTANCES)
+thread_local PPU& ppubase = ppu;
+#else
 PPU& ppubase = ppu;
+#endif
 
 #define PPU PPUfast
 #define ppu ppufast
 
-PPU ppu;
+SFC_GLOBAL(PPU, ppu);
 #include "io.cpp"
 #include "line.cpp"
+#include "renderer.cpp"
 #include "background.cpp"
 #include "mode7.cpp"
 #include "mode7hd.cpp"
@@ -44,25 +49,27 @@ static auto naturalOr(const char *a, const F &b) -> unsigned int {
   return astr.natural();
 }
 
-PPU::PPU()
-  : threadPool()
-{
+uint16 PPU::lightTable[16][32768];
+
+PPU::PPU() {
   output = new uint16_t[2304 * 2160]();
 
-  for(uint l : range(16)) {
-    lightTable[l] = new uint16_t[32768];
-    for(uint r : range(32)) {
-      for(uint g : range(32)) {
-        for(uint b : range(32)) {
-          double luma = (double)l / 15.0;
-          uint ar = (luma * r + 0.5);
-          uint ag = (luma * g + 0.5);
-          uint ab = (luma * b + 0.5);
-          lightTable[l][r << 10 | g << 5 | b << 0] = ab << 10 | ag << 5 | ar << 0;
+  static std::once_flag lightTableBuilt;
+  std::call_once(lightTableBuilt, [] {
+    for(uint l : range(16)) {
+      for(uint r : range(32)) {
+        for(uint g : range(32)) {
+          for(uint b : range(32)) {
+            double luma = (double)l / 15.0;
+            uint ar = (luma * r + 0.5);
+            uint ag = (luma * g + 0.5);
+            uint ab = (luma * b + 0.5);
+            lightTable[l][r << 10 | g << 5 | b << 0] = ab << 10 | ag << 5 | ar << 0;
+          }
         }
       }
     }
-  }
+  });
 
   for(uint y : range(240)) {
     lines[y].y = y;
@@ -71,7 +78,6 @@ PPU::PPU()
 
 PPU::~PPU() {
   delete[] output;
-  for(uint l : range(16)) delete[] lightTable[l];
 }
 
 auto PPU::synchronizeCPU() -> void {
@@ -148,7 +154,7 @@ auto PPU::scanline() -> void {
 
   if(vcounter() == 240) {
     Line::flush();
-    threadPool.resize(configuration.hacks.ppu.threads);
+    renderer.resize(configuration.hacks.ppu.threads, configuration.hacks.ppu.threadSpin);
   }
 }
 
@@ -177,7 +183,7 @@ auto PPU::refresh() -> void {
       }
     }
 
-    // [jsd] run AngelScript post_frame() function if available:
+    // [jsd] run AngelScript post_frame() function of each script module that defines it:
     if (script.funcs.post_frame) {
       ppuFrame.output = output;
       ppuFrame.pitch  = pitch;
@@ -185,9 +191,13 @@ auto PPU::refresh() -> void {
       ppuFrame.height = height;
       ppuFrame.width_mult  = (width / 256u);
       ppuFrame.height_mult = (height / 240u);
-      script.context->Prepare(script.funcs.post_frame);
-      ScriptInterface::executeScript(script.context);
+      for (auto func : script.funcs.post_frame) {
+        script.context->Prepare(func);
+        ScriptInterface::executeScript(script.context);
+      }
     }
+    // [jsd] composite retained script overlay layers:
+    ScriptInterface::compositeOverlay(output, pitch, width, height);
 
     if(auto device = controllerPort2.device) device->draw(output, pitch * sizeof(uint16), width, height);
     platform->videoFrame(output, pitch * sizeof(uint16), width, height, hd() ? hdScale() : 1);
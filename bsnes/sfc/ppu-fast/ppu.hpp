@@ -303,7 +303,8 @@ public:
 
   //[unserialized]
   uint16* output = {};
-  uint16* lightTable[16] = {};
+  //[jsd] the same for every console, so it is built once per process:
+  static uint16 lightTable[16][32768];
 
   // extra tiles for scripts to use to blend custom graphics into the PPU planes:
   ExtraTile extraTiles[128] = {};
@@ -371,8 +372,8 @@ public:
     bool windowBelow[256];
 
     //flush()
-    static uint start;
-    static uint count;
+    static instance_local uint start;
+    static instance_local uint count;
   };
 
 //unserialized:
@@ -393,9 +394,47 @@ public:
     int endLerpLine[32];
   } mode7LineGroups;
 
-  thread_pool threadPool;
+  //[jsd] time spent in Line::render() summed across render threads; only measured while enabled:
+  struct Statistics {
+    bool enabled = false;
+    std::atomic<uint64> renderNanoseconds{0};
+  } statistics;
+
+  //renderer.cpp
+  //[jsd] scanline render jobs are published to a fixed ring and claimed by persistent workers. The emulation thread
+  //renders lines itself while it waits for the frame to complete in Line::flush().
+  struct Renderer {
+    enum : uint { Capacity = 256 };
+    enum : uint { Field0 = 0, Field1 = 1, BothFields = 2 };
+
+    ~Renderer();
+
+    auto resize(uint threads, uint spinMicroseconds) -> void;
+    auto submit(uint y, uint mode) -> void;
+    auto wait() -> void;
+
+  private:
+    auto claim(uint16& job) -> bool;
+    auto run(uint16 job) -> void;
+    auto worker() -> void;
+    auto stop() -> void;
+
+    //job = y | mode << 8
+    std::atomic<uint16> jobs[Capacity] = {};
+    alignas(64) std::atomic<uint> head{0};  //written by the emulation thread only
+    alignas(64) std::atomic<uint> tail{0};  //advanced by whichever thread claims the next job
+    alignas(64) std::atomic<uint> completed{0};
+    uint submitted = 0;
+
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::atomic<uint> sleepers{0};
+    std::atomic<bool> stopping{false};
+    uint spinMicroseconds = 0;
+  } renderer;
 };
 
-extern PPU ppufast;
+SFC_EXTERN(PPU, ppufast);
 
 #undef PPU
@@ -0,0 +1,119 @@
+static inline auto renderPause() -> void {
+#if defined(ARCHITECTURE_AMD64) || defined(ARCHITECTURE_X86)
+  __builtin_ia32_pause();
+#else
+  std::this_thread::yield();
+#endif
+}
+
+PPU::Renderer::~Renderer() {
+  stop();
+}
+
+//must only be called between frames, when no jobs are outstanding:
+auto PPU::Renderer::resize(uint threads, uint spinMicroseconds) -> void {
+  this->spinMicroseconds = spinMicroseconds;
+  if(threads == workers.size()) return;
+
+  stop();
+#if defined(EMULATOR_INSTANCES)
+  //workers render the lines of the console that started them:
+  auto instance = &Instance::active();
+  for(uint n : range(threads)) workers.emplace_back([this, instance] { Instance::bind(*instance); worker(); });
+#else
+  for(uint n : range(threads)) workers.emplace_back([this] { worker(); });
+#endif
+}
+
+auto PPU::Renderer::submit(uint y, uint mode) -> void {
+  uint16 job = y | mode << 8;
+  submitted++;
+
+  uint index = head.load(std::memory_order_relaxed);
+  if(!workers.size() || index - tail.load(std::memory_order_acquire) >= Capacity) {
+    return run(job);
+  }
+
+  jobs[index & (Capacity - 1)].store(job, std::memory_order_relaxed);
+  head.store(index + 1, std::memory_order_seq_cst);
+
+  //pairs with the sleepers increment in worker(): either the worker sees the new head or we see the sleeper.
+  if(sleepers.load(std::memory_order_seq_cst)) {
+    std::lock_guard<std::mutex> lock(mutex);
+    wake.notify_all();
+  }
+}
+
+//helps render any lines still queued, then waits for lines being rendered by workers:
+auto PPU::Renderer::wait() -> void {
+  uint16 job;
+  while(completed.load(std::memory_order_acquire) != submitted) {
+    if(claim(job)) run(job);
+    else renderPause();
+  }
+}
+
+//the job is read before the claim; the producer never overwrites a slot that has not been claimed yet.
+auto PPU::Renderer::claim(uint16& job) -> bool {
+  uint index = tail.load(std::memory_order_acquire);
+  while(index != head.load(std::memory_order_acquire)) {
+    job = jobs[index & (Capacity - 1)].load(std::memory_order_relaxed);
+    if(tail.compare_exchange_weak(index, index + 1, std::memory_order_acq_rel)) return true;
+  }
+  return false;
+}
+
+auto PPU::Renderer::run(uint16 job) -> void {
+  auto& line = ppu.lines[job & 0xff];
+  uint64 start = ppu.statistics.enabled ? chrono::nanosecond() : 0;
+
+  switch(job >> 8) {
+  case Field0: line.render(0); break;
+  case Field1: line.render(1); break;
+  case BothFields: line.render(0); line.render(1); break;
+  }
+
+  if(start) ppu.statistics.renderNanoseconds += chrono::nanosecond() - start;
+  completed.fetch_add(1, std::memory_order_release);
+}
+
+//workers spin for a short while after running out of jobs, since the next scanline normally arrives within
+//microseconds; they park on the condition variable once the spin budget is spent (e.g. during vblank).
+auto PPU::Renderer::worker() -> void {
+  uint16 job;
+  while(!stopping.load(std::memory_order_acquire)) {
+    if(claim(job)) {
+      run(job);
+      continue;
+    }
+
+    bool pending = false;
+    auto deadline = chrono::microsecond() + spinMicroseconds;
+    do {
+      renderPause();
+      pending = head.load(std::memory_order_relaxed) != tail.load(std::memory_order_relaxed);
+    } while(!pending && !stopping.load(std::memory_order_relaxed) && chrono::microsecond() < deadline);
+    if(pending) continue;
+
+    std::unique_lock<std::mutex> lock(mutex);
+    sleepers.fetch_add(1, std::memory_order_seq_cst);
+    wake.wait(lock, [&] {
+      return stopping.load(std::memory_order_seq_cst)
+          || head.load(std::memory_order_seq_cst) != tail.load(std::memory_order_seq_cst);
+    });
+    sleepers.fetch_sub(1, std::memory_order_seq_cst);
+  }
+}
+
+auto PPU::Renderer::stop() -> void {
+  if(!workers.size()) return;
+
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stopping = true;
+  }
+  wake.notify_all();
+  for(auto& thread : workers) thread.join();
+  workers.clear();
+  stopping = false;
+}
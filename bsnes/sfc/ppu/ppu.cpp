@@ -2,8 +2,9 @@
 
 namespace SuperFamicom {
 
-PPU ppu;
-PPUFrame ppuFrame;
+SFC_GLOBAL(PPU, ppu);
+SFC_GLOBAL(PPUFrame, ppuFrame);
+uint16 PPU::lightTable[16][32768];
 
 #include "main.cpp"
 #include "io.cpp"
@@ -23,19 +24,22 @@ bg4(Background::ID::BG4) {
   ppu1.version = 1;  //allowed values: 1
   ppu2.version = 3;  //allowed values: 1, 2, 3
 
-  for(uint l = 0; l < 16; l++) {
-    for(uint r = 0; r < 32; r++) {
-      for(uint g = 0; g < 32; g++) {
-        for(uint b = 0; b < 32; b++) {
-          double luma = (double)l / 15.0;
-          uint ar = (luma * r + 0.5);
-          uint ag = (luma * g + 0.5);
-          uint ab = (luma * b + 0.5);
-          lightTable[l][(r << 10) + (g << 5) + b] = (ab << 10) + (ag << 5) + ar;
+  static std::once_flag lightTableBuilt;
+  std::call_once(lightTableBuilt, [] {
+    for(uint l = 0; l < 16; l++) {
+      for(uint r = 0; r < 32; r++) {
+        for(uint g = 0; g < 32; g++) {
+          for(uint b = 0; b < 32; b++) {
+            double luma = (double)l / 15.0;
+            uint ar = (luma * r + 0.5);
+            uint ag = (luma * g + 0.5);
+            uint ab = (luma * b + 0.5);
+            lightTable[l][(r << 10) + (g << 5) + b] = (ab << 10) + (ag << 5) + ar;
+          }
         }
       }
     }
-  }
+  });
 }
 
 PPU::~PPU() {
@@ -200,7 +204,7 @@ auto PPU::refresh() -> void {
   auto width  = 512;
   auto height = 480;
 
-  // [jsd] run AngelScript post_frame() function if available:
+  // [jsd] run AngelScript post_frame() function of each script module that defines it:
   if (script.funcs.post_frame) {
     ppuFrame.output = output;
     ppuFrame.pitch  = pitch;
@@ -208,9 +212,13 @@ auto PPU::refresh() -> void {
     ppuFrame.height = height;
     ppuFrame.width_mult  = (width / 256);
     ppuFrame.height_mult = (height / 240);
-    script.context->Prepare(script.funcs.post_frame);
-    ScriptInterface::executeScript(script.context);
+    for (auto func : script.funcs.post_frame) {
+      script.context->Prepare(func);
+      ScriptInterface::executeScript(script.context);
+    }
   }
+  // [jsd] composite retained script overlay layers:
+  ScriptInterface::compositeOverlay(output, pitch, width, height);
 
   if(configuration.video.blurEmulation) {
     for(uint y : range(height)) {
@@ -53,7 +53,8 @@ private:
   } vram;
 
   uint16 output[512 * 480];
-  uint16 lightTable[16][32768];
+  //[jsd] the same for every console, so it is built once per process:
+  static uint16 lightTable[16][32768];
 
   struct {
     bool interlace;
@@ -173,9 +174,10 @@ private:
   friend class PPU::Window;
   friend class PPU::Screen;
   friend class System;
+  friend class StateExport;
   friend class PPUfast;
   friend class ScriptInterface::PPUAccess;
   friend class ScriptInterface::GUI;
 };
 
-extern PPU ppu;
+SFC_EXTERN(PPU, ppu);
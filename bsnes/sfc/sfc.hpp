@@ -7,6 +7,8 @@
 #include <emulator/random.hpp>
 #include <emulator/cheat.hpp>
 
+#include <nall/shared-memory.hpp>
+
 #include <processor/arm7tdmi/arm7tdmi.hpp>
 #include <processor/gsu/gsu.hpp>
 #include <processor/hg51b/hg51b.hpp>
@@ -24,8 +26,19 @@ namespace SuperFamicom {
   namespace File = Emulator::File;
   using Random = Emulator::Random;
   using Cheat = Emulator::Cheat;
-  extern Random random;
-  extern Cheat cheat;
+
+  //[jsd] the components of a console are global objects. Built with EMULATOR_INSTANCES, each of them is a thread-local
+  //reference into the Instance bound to the calling thread instead (see sfc/system/instance.hpp):
+  #if defined(EMULATOR_INSTANCES)
+    #define SFC_EXTERN(type, name) extern thread_local type& name
+    #define SFC_GLOBAL(type, name) thread_local type& name = Instance::active().name
+  #else
+    #define SFC_EXTERN(type, name) extern type name
+    #define SFC_GLOBAL(type, name) type name
+  #endif
+
+  SFC_EXTERN(Random, random);
+  SFC_EXTERN(Cheat, cheat);
 
   struct Scheduler {
     enum class Mode : uint { Run, Synchronize } mode;
@@ -70,7 +83,7 @@ namespace SuperFamicom {
       desynchronized = true;
     }
   };
-  extern Scheduler scheduler;
+  SFC_EXTERN(Scheduler, scheduler);
 
   struct Thread {
     enum : uint { Size = 4_KiB * sizeof(void*) };
@@ -95,7 +108,7 @@ namespace SuperFamicom {
     }
 
     auto serializeStack(serializer& s) -> void {
-      static uint8_t stack[Thread::Size];
+      static instance_local uint8_t stack[Thread::Size];
       bool active = co_active() == thread;
 
       if(s.mode() == serializer::Size) {
@@ -131,24 +144,56 @@ namespace SuperFamicom {
     asIScriptEngine  *engine = nullptr;
     asIScriptContext *context = nullptr;
 
-    vector<asIScriptModule *> modules;
-    asIScriptModule          *main_module = nullptr;
-
-    vector<hiro::Window> windows;
-
+    // one module for the *.as files in the script folder ("main") and one for each subfolder containing *.as files:
+    struct Module {
+      string name;
+      string key;  // bytecode cache key of the sources the module was built from
+      asIScriptModule *module = nullptr;
+
+      struct {
+        asIScriptFunction *init = nullptr;
+        asIScriptFunction *unload = nullptr;
+        asIScriptFunction *post_power = nullptr;
+        asIScriptFunction *cartridge_loaded = nullptr;
+        asIScriptFunction *cartridge_unloaded = nullptr;
+        asIScriptFunction *pre_nmi = nullptr;
+        asIScriptFunction *pre_frame = nullptr;
+        asIScriptFunction *post_frame = nullptr;
+        asIScriptFunction *palette_updated = nullptr;
+      } funcs;
+    };
+    string location;
+    vector<Module> modules;
+
+    struct Window {
+      asIScriptModule *module;  // module that created the window
+      hiro::Window window;
+    };
+    vector<Window> windows;
+
+    // true when any buffered write interceptors are registered:
+    bool writeEvents = false;
+    // set by the network reactor when net::on_ready() should be called:
+    std::atomic<bool> netEvents{false};
+    // true while run-ahead emulates frames that are rolled back afterwards:
+    bool speculative = false;
+    // true when callbacks are registered with ppu::on_scanline() or ppu::on_hv():
+    bool rasterEvents = false;
+
+    // callbacks of all loaded modules, in module order:
     struct {
-      asIScriptFunction *init = nullptr;
-      asIScriptFunction *unload = nullptr;
-      asIScriptFunction *post_power = nullptr;
-      asIScriptFunction *cartridge_loaded = nullptr;
-      asIScriptFunction *cartridge_unloaded = nullptr;
-      asIScriptFunction *pre_nmi = nullptr;
-      asIScriptFunction *pre_frame = nullptr;
-      asIScriptFunction *post_frame = nullptr;
-      asIScriptFunction *palette_updated = nullptr;
+      vector<asIScriptFunction *> init;
+      vector<asIScriptFunction *> unload;
+      vector<asIScriptFunction *> post_power;
+      vector<asIScriptFunction *> cartridge_loaded;
+      vector<asIScriptFunction *> cartridge_unloaded;
+      vector<asIScriptFunction *> pre_nmi;
+      vector<asIScriptFunction *> pre_frame;
+      vector<asIScriptFunction *> post_frame;
+      vector<asIScriptFunction *> palette_updated;
     } funcs;
   };
-  extern Script script;
+  SFC_EXTERN(Script, script);
 
   // used for scripts to read/write to PPU frame:
   struct PPUFrame {
@@ -159,16 +204,28 @@ namespace SuperFamicom {
     int  width_mult  = 2;
     int  height_mult = 2;
   };
-  extern PPUFrame ppuFrame;
+  SFC_EXTERN(PPUFrame, ppuFrame);
 
   namespace ScriptInterface {
     struct PPUAccess;
     struct GUI;
     struct PostFrame;
     auto executeScript(asIScriptContext *ctx) -> void;
+    auto deliverWriteEvents(uint vcounter) -> void;
+    auto deliverNetEvents(uint vcounter) -> void;
+    auto deliverScanlineEvents(uint vcounter, uint hcounter) -> uint;
+    auto deliverRasterEvents(uint hcounter) -> uint;
+    auto skipSpeculative(asIScriptFunction *func) -> bool;
+    auto runAheadSave() -> void;
+    auto runAheadLoad() -> void;
+    auto compositeOverlay(uint16 *output, uint pitch, uint width, uint height) -> void;
+    auto profileFrame() -> void;
+    auto profileEnable(bool enable) -> void;
+    auto profileNanoseconds() -> uint64;
   }
 
   #include <sfc/system/system.hpp>
+  #include <sfc/system/state-export.hpp>
   #include <sfc/memory/memory.hpp>
   #include <sfc/ppu/counter/counter.hpp>
 
@@ -189,3 +246,7 @@ namespace SuperFamicom {
 }
 
 #include <sfc/interface/interface.hpp>
+
+namespace SuperFamicom {
+  #include <sfc/system/instance.hpp>
+}
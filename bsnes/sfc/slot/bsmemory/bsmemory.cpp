@@ -2,7 +2,7 @@
 
 namespace SuperFamicom {
 
-BSMemory bsmemory;
+SFC_GLOBAL(BSMemory, bsmemory);
 #include "serialization.cpp"
 
 BSMemory::BSMemory() {
@@ -165,4 +165,4 @@ private:
   auto failed() -> void;
 };
 
-extern BSMemory bsmemory;
+SFC_EXTERN(BSMemory, bsmemory);
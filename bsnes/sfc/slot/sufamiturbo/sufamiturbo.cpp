@@ -3,8 +3,8 @@
 namespace SuperFamicom {
 
 #include "serialization.cpp"
-SufamiTurboCartridge sufamiturboA;
-SufamiTurboCartridge sufamiturboB;
+SFC_GLOBAL(SufamiTurboCartridge, sufamiturboA);
+SFC_GLOBAL(SufamiTurboCartridge, sufamiturboB);
 
 auto SufamiTurboCartridge::unload() -> void {
   rom.reset();
@@ -8,5 +8,5 @@ struct SufamiTurboCartridge {
   WritableMemory ram;
 };
 
-extern SufamiTurboCartridge sufamiturboA;
-extern SufamiTurboCartridge sufamiturboB;
+SFC_EXTERN(SufamiTurboCartridge, sufamiturboA);
+SFC_EXTERN(SufamiTurboCartridge, sufamiturboB);
@@ -2,7 +2,7 @@
 
 namespace SuperFamicom {
 
-SMP smp;
+SFC_GLOBAL(SMP, smp);
 #include "memory.cpp"
 #include "io.cpp"
 #include "timing.cpp"
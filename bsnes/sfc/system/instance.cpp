@@ -0,0 +1,95 @@
+#if defined(EMULATOR_INSTANCES)
+
+static thread_local Instance* boundInstance = nullptr;
+static thread_local std::unique_ptr<Instance, decltype(&Instance::destroy)> ownedInstance{nullptr, &Instance::destroy};
+
+auto Instance::active() -> Instance& {
+  if(!boundInstance) ownedInstance.reset(create());
+  return *boundInstance;
+}
+
+auto Instance::bind(Instance& instance) -> void {
+  boundInstance = &instance;
+}
+
+//the console is bound before it is constructed, so that constructors which use another component already refer to it
+//rather than to the previous binding (or create a second console):
+auto Instance::create() -> Instance* {
+  auto storage = ::operator new(sizeof(Instance), std::align_val_t{alignof(Instance)});
+  boundInstance = (Instance*)storage;
+  return new(storage) Instance;
+}
+
+auto Instance::destroy(Instance* instance) -> void {
+  instance->~Instance();
+  ::operator delete(instance, std::align_val_t{alignof(Instance)});
+}
+
+//runs the console until it completed a frame:
+auto Instance::runFrame() -> void {
+  if(!system.loaded()) return;
+  do {
+    interface.run();
+  } while(scheduler.event != Scheduler::Event::EndFrame);
+}
+
+auto InstancePool::create(uint count) -> void {
+  destroy();
+  generation = 0;
+  stopping = false;
+  for(uint index : range(count)) workers.emplace_back([this, index] { main(index); });
+}
+
+auto InstancePool::destroy() -> void {
+  if(workers.empty()) return;
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stopping = true;
+  }
+  wake.notify_all();
+  for(auto& worker : workers) worker.join();
+  workers.clear();
+}
+
+//calls task on every worker at once, and returns when all of them are done:
+auto InstancePool::run(const function<void (uint index)>& task) -> void {
+  if(workers.empty()) return;
+  std::unique_lock<std::mutex> lock(mutex);
+  this->task = task;
+  pending = workers.size();
+  generation++;
+  wake.notify_all();
+  done.wait(lock, [&] { return pending == 0; });
+}
+
+auto InstancePool::step(uint frames) -> void {
+  run([frames](uint) {
+    auto& instance = Instance::active();
+    for(uint n : range(frames)) instance.runFrame();
+  });
+}
+
+auto InstancePool::main(uint index) -> void {
+  //the console is created on its worker, so that its memory is allocated close to the core running it:
+  auto instance = Instance::create();
+
+  uint seen = 0;
+  while(true) {
+    function<void (uint)> work;
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      wake.wait(lock, [&] { return stopping || generation != seen; });
+      if(generation == seen) break;
+      seen = generation;
+      work = task;
+    }
+    work(index);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if(--pending == 0) done.notify_all();
+  }
+
+  Instance::destroy(instance);
+}
+
+#endif
@@ -0,0 +1,108 @@
+#if defined(EMULATOR_INSTANCES)
+
+//[jsd] one console: every component that is a global object in a regular build. Built with EMULATOR_INSTANCES
+//(make instances=true), the globals are thread-local references into the Instance bound to the calling thread, so that
+//a process runs as many independent consoles as it has threads. This costs some speed in each console, as every access
+//to a component goes through a thread-local reference.
+//
+//shared by all consoles in the process:
+//* the light tables of both PPUs;
+//* ROM contents and bus lookup tables, as long as they are the same; a console that writes to them gets its own copy;
+//* configuration, so set it up before the consoles are created. Hacks/PPU/Threads should be 0, since every console
+//  renders on its own thread already;
+//* the script bridge, so only one console at a time may load scripts.
+struct Instance {
+  //the instance bound to the calling thread. a thread that was not bound to one creates its own on first use:
+  static auto active() -> Instance&;
+  //must be called before the thread uses any component, as their references are bound on first use:
+  static auto bind(Instance& instance) -> void;
+  //constructs a console that is bound to the calling thread, and destroys one again:
+  static auto create() -> Instance*;
+  static auto destroy(Instance* instance) -> void;
+
+  auto runFrame() -> void;
+
+  System system;
+  Scheduler scheduler;
+  Random random;
+  Cheat cheat;
+  Script script;
+  Settings settings;
+  StateExport stateExport;
+  Bus bus;
+
+  CPU cpu;
+  SMP smp;
+  DSP dsp;
+  PPU ppu;
+  PPUfast ppufast;
+  PPUFrame ppuFrame;
+
+  ControllerPort controllerPort1;
+  ControllerPort controllerPort2;
+  ExpansionPort expansionPort;
+
+  Cartridge cartridge;
+  ICD icd;
+  MCC mcc;
+  DIP dip;
+  Event event;
+  SA1 sa1;
+  SuperFX superfx;
+  ArmDSP armdsp;
+  HitachiDSP hitachidsp;
+  NECDSP necdsp;
+  EpsonRTC epsonrtc;
+  SharpRTC sharprtc;
+  SPC7110 spc7110;
+  SDD1 sdd1;
+  OBC1 obc1;
+  MSU1 msu1;
+  Cx4 cx4;
+  DSP1 dsp1;
+  DSP2 dsp2;
+  DSP4 dsp4;
+  ST0010 st0010;
+  BSMemory bsmemory;
+  SufamiTurboCartridge sufamiturboA;
+  SufamiTurboCartridge sufamiturboB;
+
+  Interface interface;
+};
+
+//runs consoles in parallel, one per worker thread. a console may only be used on its own worker, which run() takes
+//care of; each worker has to set Emulator::platform before it loads a game:
+//
+//  InstancePool pool;
+//  pool.create(count);
+//  pool.run([&](uint index) {
+//    Emulator::platform = &platforms[index];
+//    auto& interface = Instance::active().interface;
+//    if(interface.load()) interface.power();
+//  });
+//  pool.step(60);  //every console runs 60 frames
+//  pool.run([&](uint index) { Instance::active().interface.unload(); });
+struct InstancePool {
+  ~InstancePool() { destroy(); }
+
+  auto size() const -> uint { return workers.size(); }
+
+  auto create(uint count) -> void;
+  auto destroy() -> void;
+  auto run(const function<void (uint index)>& task) -> void;
+  auto step(uint frames = 1) -> void;
+
+private:
+  auto main(uint index) -> void;
+
+  std::vector<std::thread> workers;
+  std::mutex mutex;
+  std::condition_variable wake;
+  std::condition_variable done;
+  function<void (uint)> task;
+  uint generation = 0;
+  uint pending = 0;
+  bool stopping = false;
+};
+
+#endif
@@ -0,0 +1,80 @@
+SFC_GLOBAL(StateExport, stateExport);
+
+auto StateExport::slot(uint index) -> Slot* {
+  return (Slot*)(segment.data() + header->slotOffset[index]);
+}
+
+//creates the segment; an empty name disables the export:
+auto StateExport::open(const string& name) -> bool {
+  if(name == _name && (header || !name)) return (bool)header;
+  close();
+  if(!name) return false;
+
+  uint size = sizeof(Header) + Slots * sizeof(Slot);
+  if(!segment.create(name, size)) return false;
+  _name = name;
+
+  //the segment is zero-filled, so every slot starts with an even sequence number:
+  header = new(segment.data()) Header{};
+  memory::copy(header->magic, "BSNESST", 8);
+  header->version = Version;
+  header->headerSize = sizeof(Header);
+  header->slotSize = sizeof(Slot);
+  header->slotCount = Slots;
+  for(uint n : range(Slots)) {
+    header->slotOffset[n] = sizeof(Header) + n * sizeof(Slot);
+    new(slot(n)) Slot{};
+  }
+  header->latest.store(0, std::memory_order_release);
+  return true;
+}
+
+auto StateExport::close() -> void {
+  header = nullptr;
+  _name = "";
+  segment.reset();
+}
+
+//copies the state at the end of a frame into the slot readers are not directed to, then directs them to it:
+auto StateExport::publish() -> void {
+  uint index = !header->latest.load(std::memory_order_relaxed);
+  auto target = slot(index);
+
+  uint32_t sequence = target->sequence.load(std::memory_order_relaxed);
+  target->sequence.store(sequence + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+
+  target->frame = header->frames + 1;
+
+  auto& r = cpu.r;
+  target->cpu.pc = r.pc.d;
+  target->cpu.a = r.a.w;
+  target->cpu.x = r.x.w;
+  target->cpu.y = r.y.w;
+  target->cpu.s = r.s.w;
+  target->cpu.d = r.d.w;
+  target->cpu.db = r.b;
+  target->cpu.p = r.p;
+  target->cpu.e = r.e;
+
+  memory::copy(target->wram, cpu.wram, sizeof(target->wram));
+
+  if(system.fastPPU()) {
+    target->vramSize = sizeof(ppufast.vram);
+    memory::copy(target->vram, ppufast.vram, sizeof(ppufast.vram));
+    memory::copy(target->cgram, ppufast.cgram, sizeof(ppufast.cgram));
+    memory::copy(target->oam, ppufast.oam, sizeof(ppufast.oam));
+  } else {
+    target->vramSize = (ppu.vram.mask + 1) * sizeof(uint16_t);
+    memory::copy(target->vram, ppu.vram.data, target->vramSize);
+    for(uint n : range(256)) {
+      uint16_t color = ppu.screen.cgram[n];
+      memory::copy(target->cgram + n * 2, &color, 2);
+    }
+    memory::copy(target->oam, ppu.obj.oam.oam, sizeof(target->oam));
+  }
+
+  target->sequence.store(sequence + 2, std::memory_order_release);
+  header->frames++;
+  header->latest.store(index, std::memory_order_release);
+}
@@ -0,0 +1,78 @@
+//publishes WRAM, VRAM, CGRAM, OAM and the CPU registers to a named shared memory segment at the end of every frame,
+//so that external tools can read emulator state at frame rate without sockets or copies.
+//
+//the segment is named "/nall-<name>" (e.g. /dev/shm/nall-bsnes-state on Linux) and consists of a Header followed by
+//two Slots. All values are in host byte order; VRAM and CGRAM are arrays of 16-bit words. The core writes each frame
+//into the slot that is not the latest one and then makes it the latest. A slot's sequence number is odd while the core
+//writes to it, so a reader reads a consistent frame in place like this:
+//
+//  1. slot = header.latest; s1 = slots[slot].sequence (acquire); retry if s1 is odd
+//  2. read what is needed straight from slots[slot]
+//  3. acquire fence; s2 = slots[slot].sequence; retry if s1 != s2 (the core overwrote the slot meanwhile)
+//
+//as the core alternates between the slots, a retry only happens when reading takes longer than a frame.
+//shared memory is only implemented for POSIX systems.
+
+struct StateExport {
+  enum : uint32_t { Version = 1, Slots = 2 };
+
+  struct Registers {
+    uint32_t pc;  //24-bit program counter including the program bank
+    uint16_t a;
+    uint16_t x;
+    uint16_t y;
+    uint16_t s;
+    uint16_t d;
+     uint8_t db;
+     uint8_t p;
+     uint8_t e;   //emulation mode
+     uint8_t reserved[11];
+  };
+
+  struct Slot {
+    std::atomic<uint32_t> sequence;  //odd while the core writes to this slot
+    uint32_t reserved;
+    uint64_t frame;       //value of Header::frames this slot was published as
+    Registers cpu;
+    uint32_t vramSize;    //bytes of VRAM in use: 64 KiB, or 128 KiB if configured
+    uint32_t reserved2[11];
+     uint8_t wram[128 * 1024];
+     uint8_t vram[128 * 1024];
+     uint8_t cgram[512];
+     uint8_t oam[544];
+  };
+
+  struct Header {
+        char magic[8];    //"BSNESST\0"
+    uint32_t version;     //Version
+    uint32_t headerSize;  //sizeof(Header)
+    uint32_t slotSize;    //sizeof(Slot)
+    uint32_t slotCount;   //Slots
+    uint32_t slotOffset[Slots];      //byte offset of each slot from the start of the segment
+    std::atomic<uint32_t> latest;    //index of the most recently published slot
+    uint32_t reserved;
+    uint64_t frames;      //frames published since the segment was created
+     uint8_t reserved2[16];
+  };
+
+  static_assert(sizeof(Header) == 64);
+  static_assert(sizeof(Slot) % 64 == 0);
+  static_assert(std::atomic<uint32_t>::is_always_lock_free);
+
+  explicit operator bool() const { return header; }
+  auto name() const -> string { return _name; }
+
+  //state-export.cpp
+  auto open(const string& name) -> bool;
+  auto close() -> void;
+  auto publish() -> void;
+
+private:
+  auto slot(uint index) -> Slot*;
+
+  shared_memory segment;
+  string _name;
+  Header* header = nullptr;
+};
+
+SFC_EXTERN(StateExport, stateExport);
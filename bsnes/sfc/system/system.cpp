@@ -2,12 +2,14 @@
 
 namespace SuperFamicom {
 
-System system;
-Scheduler scheduler;
-Random random;
-Cheat cheat;
-Script script;
+SFC_GLOBAL(System, system);
+SFC_GLOBAL(Scheduler, scheduler);
+SFC_GLOBAL(Random, random);
+SFC_GLOBAL(Cheat, cheat);
+SFC_GLOBAL(Script, script);
 #include "serialization.cpp"
+#include "state-export.cpp"
+#include "instance.cpp"
 
 auto System::run() -> void {
   scheduler.mode = Scheduler::Mode::Run;
@@ -104,17 +106,22 @@ auto System::runToSaveStrict() -> void {
 }
 
 auto System::frameStartEvent() -> void {
-  // [jsd] run AngelScript pre_frame() function if available:
-  if (script.funcs.pre_frame) {
-    script.context->Prepare(script.funcs.pre_frame);
+  // [jsd] close out per-frame script profiling:
+  ScriptInterface::profileFrame();
+
+  // [jsd] run AngelScript pre_frame() function of each script module that defines it:
+  for (auto func : script.funcs.pre_frame) {
+    if (script.speculative && ScriptInterface::skipSpeculative(func)) continue;
+    script.context->Prepare(func);
     ScriptInterface::executeScript(script.context);
   }
 }
 
 auto System::framePreNMIEvent() -> void {
-  // [jsd] run AngelScript pre_nmi() function if available:
-  if (script.funcs.pre_nmi) {
-    script.context->Prepare(script.funcs.pre_nmi);
+  // [jsd] run AngelScript pre_nmi() function of each script module that defines it:
+  for (auto func : script.funcs.pre_nmi) {
+    if (script.speculative && ScriptInterface::skipSpeculative(func)) continue;
+    script.context->Prepare(func);
     ScriptInterface::executeScript(script.context);
   }
 }
@@ -122,14 +129,21 @@ auto System::framePreNMIEvent() -> void {
 auto System::frameEvent() -> void {
   ppu.refresh();
 
-  //refresh all cheat codes once per frame
-  Memory::GlobalWriteEnable = true;
-  for (auto &code : cheat.codes) {
-    if (code.enable) {
-      bus.write(code.address, code.data);
-    }
+  //refresh all WRAM cheat codes once per frame; their addresses are offsets into WRAM
+  for(auto& code : cheat.codes) {
+    auto& byte = cpu.wram[code.address];
+    if(!code.compare || code.compare() == byte) byte = code.data;
   }
-  Memory::GlobalWriteEnable = false;
+
+  if(stateExport && !runAhead) stateExport.publish();
+  flushAudio();
+}
+
+//[jsd] hands the batched samples of every audio source to its stream, so that none are held back across frames:
+auto System::flushAudio() -> void {
+  dsp.flushSamples();
+  if(cartridge.has.ICD) icd.apuFlush();
+  if(cartridge.has.MSU1) msu1.audioFlush();
 }
 
 auto System::load(Emulator::Interface* interface) -> bool {
@@ -165,9 +179,9 @@ auto System::load(Emulator::Interface* interface) -> bool {
 
   this->interface = interface;
 
-  // [jsd] run AngelScript cartridge_loaded function if available:
-  if (script.funcs.cartridge_loaded) {
-    script.context->Prepare(script.funcs.cartridge_loaded);
+  // [jsd] run AngelScript cartridge_loaded function of each script module that defines it:
+  for (auto func : script.funcs.cartridge_loaded) {
+    script.context->Prepare(func);
     ScriptInterface::executeScript(script.context);
   }
 
@@ -183,6 +197,7 @@ auto System::save() -> void {
 auto System::unload() -> void {
   if(!loaded()) return;
 
+  flushAudio();
   controllerPort1.unload();
   controllerPort2.unload();
   expansionPort.unload();
@@ -202,10 +217,11 @@ auto System::unload() -> void {
   if(cartridge.has.SufamiTurboSlotB) sufamiturboB.unload();
 
   cartridge.unload();
+  stateExport.close();
 
-  // [jsd] run AngelScript cartridge_unloaded function if available:
-  if (script.funcs.cartridge_unloaded) {
-    script.context->Prepare(script.funcs.cartridge_unloaded);
+  // [jsd] run AngelScript cartridge_unloaded function of each script module that defines it:
+  for (auto func : script.funcs.cartridge_unloaded) {
+    script.context->Prepare(func);
     ScriptInterface::executeScript(script.context);
   }
 
@@ -274,12 +290,18 @@ auto System::power(bool reset) -> void {
   controllerPort2.connect(settings.controllerPort2);
   expansionPort.connect(settings.expansionPort);
 
+#if defined(EMULATOR_INSTANCES)
+  bus.share();
+#endif
+
+  stateExport.open(configuration.stateExport.name);
+
   information.serializeSize[0] = serializeInit(0);
   information.serializeSize[1] = serializeInit(1);
 
-  // [jsd] run AngelScript post_power function if available:
-  if (script.funcs.post_power) {
-    script.context->Prepare(script.funcs.post_power);
+  // [jsd] run AngelScript post_power function of each script module that defines it:
+  for (auto func : script.funcs.post_power) {
+    script.context->Prepare(func);
     script.context->SetArgByte(0, reset);
     ScriptInterface::executeScript(script.context);
   }
@@ -15,6 +15,7 @@ struct System {
   auto frameEvent() -> void;
   auto frameStartEvent() -> void;
   auto framePreNMIEvent() -> void;
+  auto flushAudio() -> void;
 
   auto load(Emulator::Interface*) -> bool;
   auto save() -> void;
@@ -50,7 +51,7 @@ private:
   friend class Cartridge;
 };
 
-extern System system;
+SFC_EXTERN(System, system);
 
 auto Region::NTSC() -> bool { return system.region() == System::Region::NTSC; }
 auto Region::PAL() -> bool { return system.region() == System::Region::PAL; }
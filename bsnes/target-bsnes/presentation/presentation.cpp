@@ -182,6 +182,10 @@ auto Presentation::create() -> void {
   scriptLoadFolder.setIcon(Icon::Emblem::Script).setText("Load Script Folder ...").onActivate([&] { program.scriptLoad(true); });
   scriptReload.setIcon(Icon::Emblem::Script).setText("Reload Script").onActivate([&] { program.scriptReload(); });
   scriptUnload.setIcon(Icon::Emblem::Script).setText("Unload Script").onActivate([&] { program.scriptUnload(); });
+  scriptJIT.setText("Compile Scripts to Native Code").setChecked(settings.script.jit).onToggle([&] {
+    settings.script.jit = scriptJIT.checked();
+    program.scriptJIT(settings.script.jit);
+  });
   scriptConsole.setIcon(Icon::Emblem::Script).setText("Script Console ...").onActivate([&] { toolsWindow.show(4); });
 
   helpMenu.setText(tr("Help"));
@@ -122,6 +122,7 @@ struct Presentation : Window {
       MenuItem scriptLoadFolder{&scriptMenu};
       MenuItem scriptReload{&scriptMenu};
       MenuItem scriptUnload{&scriptMenu};
+      MenuCheckItem scriptJIT{&scriptMenu};
       MenuSeparator scriptSeparatorA{&scriptMenu};
       MenuItem scriptConsole{&scriptMenu};
     Menu helpMenu{&menuBar};
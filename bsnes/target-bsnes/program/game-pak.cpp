@@ -1,4 +1,8 @@
 auto Program::openPakSuperFamicom(string name, vfs::file::mode mode) -> shared_pointer<vfs::file> {
+  //MSU-1 files are memory-mapped where possible, so that the core reads them without any I/O of its own
+  if(name.beginsWith("msu1/") && mode == vfs::file::mode::read) {
+    if(auto result = vfs::fs::file_map::open({superFamicom.location, name})) return result;
+  }
   return vfs::fs::file::open({superFamicom.location, name}, mode);
 }
 
@@ -119,13 +119,22 @@ auto Program::openRomSuperFamicom(string name, vfs::file::mode mode) -> shared_p
     return vfs::fs::file::open(path("Saves", superFamicom.location, ".srm"), mode);
   }
 
+  //MSU-1 files are memory-mapped where possible, so that the core reads them without any I/O of its own
   if(name == "msu1/data.rom") {
-    return vfs::fs::file::open({Location::notsuffix(superFamicom.location), ".msu"}, mode);
+    string location = {Location::notsuffix(superFamicom.location), ".msu"};
+    if(mode == vfs::file::mode::read) {
+      if(auto result = vfs::fs::file_map::open(location)) return result;
+    }
+    return vfs::fs::file::open(location, mode);
   }
 
   if(name.match("msu1/track*.pcm")) {
     name.trimLeft("msu1/track", 1L);
-    return vfs::fs::file::open({Location::notsuffix(superFamicom.location), name}, mode);
+    string location = {Location::notsuffix(superFamicom.location), name};
+    if(mode == vfs::file::mode::read) {
+      if(auto result = vfs::fs::file_map::open(location)) return result;
+    }
+    return vfs::fs::file::open(location, mode);
   }
 
   return {};
@@ -20,6 +20,7 @@ auto Program::load() -> void {
   emulator->configure("Hacks/Coprocessor/DelayedSync", settings.emulator.hack.coprocessor.delayedSync);
   emulator->configure("Hacks/Coprocessor/PreferHLE", settings.emulator.hack.coprocessor.preferHLE);
   emulator->configure("Hacks/SuperFX/Overclock", settings.emulator.hack.superfx.overclock);
+  emulator->configure("StateExport/Name", settings.emulator.stateExport.name);
   if(!emulator->load()) return;
 
   gameQueue = {};
@@ -325,6 +326,7 @@ auto Program::unload() -> void {
   if(emulatorSettings.autoSaveStateOnUnload.checked()) {
     saveUndoState();
   }
+  stateWriterFlush();  //states are written to paths that belong to this game
   emulator->unload();
   showMessage("Game unloaded");
   superFamicom = {};
@@ -5,6 +5,7 @@
 #include "game-rom.cpp"
 #include "paths.cpp"
 #include "states.cpp"
+#include "state-writer.cpp"
 #include "movies.cpp"
 #include "rewind.cpp"
 #include "video.cpp"
@@ -79,6 +80,7 @@ auto Program::create() -> void {
 }
 
 auto Program::main() -> void {
+  stateWriterPoll();
   updateStatus();
   video.poll();
 
@@ -132,6 +134,7 @@ auto Program::quit() -> void {
   settings.general.crashed = false;
 
   unload();
+  stateWriterStop();
   settings.save();
   video.reset();
   audio.reset();
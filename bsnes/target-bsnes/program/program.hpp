@@ -58,12 +58,46 @@ struct Program : Lock, Emulator::Platform {
   auto hasState(string filename) -> bool;
   auto loadStateData(string filename) -> vector<uint8_t>;
   auto loadState(string filename) -> bool;
-  auto saveState(string filename) -> bool;
+  auto saveState(string filename, bool notify = true) -> bool;  //true once queued, not once written
   auto saveUndoState() -> bool;
   auto saveRedoState() -> bool;
   auto removeState(string filename) -> bool;
   auto renameState(string from, string to) -> bool;
 
+  //state-writer.cpp
+  //compresses and writes save states on a background thread so that saving does not stall emulation:
+  struct StateWriter {
+    enum : uint { Capacity = 4 };  //pending jobs before saveState() blocks
+    struct Job {
+      string filename;  //e.g. "Quick/Slot 1"
+      string path;      //statePath() when the state was captured
+      bool archive;     //path is a state archive rather than a folder
+      bool notify;
+      serializer state;
+      image preview;
+    };
+    struct Result {
+      string filename;
+      string message;
+      bool saved;
+      bool notify;
+    };
+    std::thread thread;
+    std::mutex mutex;
+    std::condition_variable changed;
+    vector<Job> jobs;
+    vector<Result> results;
+    string active;  //filename of the job being written
+    bool busy = false;
+    bool stopping = false;
+  } stateWriter;
+  auto stateWriterEnqueue(StateWriter::Job&& job) -> void;
+  auto stateWriterMain() -> void;
+  auto stateWriterWrite(StateWriter::Job& job) -> StateWriter::Result;
+  auto stateWriterPoll() -> void;
+  auto stateWriterFlush(string filename = {}) -> void;
+  auto stateWriterStop() -> void;
+
   //movies.cpp
   struct Movie {
     enum Mode : uint { Inactive, Playing, Recording } mode = Mode::Inactive;
@@ -78,7 +112,19 @@ struct Program : Lock, Emulator::Platform {
   //rewind.cpp
   struct Rewind {
     enum Mode : uint { Playing, Rewinding } mode = Mode::Playing;
-    vector<serializer> history;
+    //the newest snapshot is kept in full; each older snapshot is stored as the run-length encoded XOR against the
+    //snapshot that followed it, in a byte ring sized to a fraction of (length * state size):
+    struct Delta {
+      uint offset;
+      uint size;
+    };
+    vector<uint8_t> current;
+    vector<uint8_t> scratch;
+    vector<uint8_t> arena;
+    uint arenaHead = 0;
+    vector<Delta> deltas;  //ring of length entries
+    uint first = 0;
+    uint count = 0;
     uint length = 0;
     uint frequency = 0;
     uint counter = 0;  //in frames
@@ -86,6 +132,10 @@ struct Program : Lock, Emulator::Platform {
   auto rewindMode(Rewind::Mode) -> void;
   auto rewindReset() -> void;
   auto rewindRun() -> void;
+  auto rewindSave() -> void;
+  auto rewindLoad() -> void;
+  auto rewindEncode(const uint8_t* target, const uint8_t* source, uint size, uint8_t* output) -> uint;
+  auto rewindDecode(uint8_t* target, const uint8_t* input, uint size) -> void;
 
   //video.cpp
   auto updateVideoDriver(Window parent) -> void;
@@ -149,6 +199,7 @@ struct Program : Lock, Emulator::Platform {
   auto scriptLoad(bool loadDirectory = false) -> void;
   auto scriptReload() -> void;
   auto scriptUnload() -> void;
+  auto scriptJIT(bool enable) -> void;
 
 public:
   struct Game {
@@ -220,6 +271,7 @@ public:
   // [jsd] add support for AngelScript
   struct Script {
     asIScriptEngine *engine;
+    CScriptJIT jit;
 
     string location;
     string console;
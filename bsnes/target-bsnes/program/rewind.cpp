@@ -5,9 +5,15 @@ auto Program::rewindMode(Rewind::Mode mode) -> void {
 
 auto Program::rewindReset() -> void {
   rewindMode(Rewind::Mode::Playing);
-  rewind.history.reset();
+  rewind.current.reset();
+  rewind.scratch.reset();
+  rewind.arena.reset();
+  rewind.arenaHead = 0;
+  rewind.deltas.reset();
+  rewind.first = 0;
+  rewind.count = 0;
   rewind.frequency = settings.rewind.frequency;
-  rewind.length = settings.rewind.length;
+  rewind.length = max(1u, settings.rewind.length);
 }
 
 auto Program::rewindRun() -> void {
@@ -17,26 +23,117 @@ auto Program::rewindRun() -> void {
     if(++rewind.counter < rewind.frequency) return;
 
     rewind.counter = 0;
-    if(rewind.history.size() >= rewind.length) {
-      rewind.history.takeFirst();
-    }
-    auto s = emulator->serialize(0);
-    rewind.history.append(s);
+    rewindSave();
     return;
   }
 
   if(rewind.mode == Rewind::Mode::Rewinding) {
-    if(rewind.history.size() == 0) return rewindMode(Rewind::Mode::Playing);  //nothing left to rewind?
+    if(!rewind.current) return rewindMode(Rewind::Mode::Playing);  //nothing left to rewind?
     if(++rewind.counter < rewind.frequency / 4) return;
 
     rewind.counter = 0;
-    auto t = rewind.history.takeLast();
-    serializer s{t.data(), t.size()};  //convert serializer::Save to serializer::Load
-    if(!rewind.history) {
-      showMessage("Rewind history exhausted");
-      rewindReset();
-    }
-    emulator->unserialize(s);
+    rewindLoad();
+    return;
+  }
+}
+
+auto Program::rewindSave() -> void {
+  auto s = emulator->serialize(0);
+
+  if(rewind.current.size() != s.size()) {
+    //first snapshot (or the state size changed): all buffers are allocated once here and reused afterward
+    rewind.current.resize(s.size());
+    rewind.scratch.resize(s.size() + s.size() / 2 + 16);
+    rewind.arena.resize(max(s.size() * rewind.length / 8, rewind.scratch.size() * 2));
+    rewind.arenaHead = 0;
+    rewind.deltas.resize(rewind.length);
+    rewind.first = 0;
+    rewind.count = 0;
+    memory::copy(rewind.current.data(), s.data(), s.size());
     return;
   }
+
+  //the delta restores the current snapshot from the new one:
+  uint size = rewindEncode(rewind.current.data(), s.data(), s.size(), rewind.scratch.data());
+  memory::copy(rewind.current.data(), s.data(), s.size());
+
+  uint offset = rewind.arenaHead;
+  bool wrapped = offset + size > rewind.arena.size();
+  if(wrapped) offset = 0;
+
+  //evict the oldest deltas until there is room in the arena and in the ring. deltas are laid out in insertion order,
+  //so when wrapping around, those past the old head are the oldest and are discarded along with the unused tail.
+  while(rewind.count) {
+    auto& oldest = rewind.deltas[rewind.first];
+    bool discard = wrapped && oldest.offset >= rewind.arenaHead;
+    bool overlaps = oldest.offset < offset + size && offset < oldest.offset + oldest.size;
+    if(!discard && !overlaps && rewind.count < rewind.length - 1) break;
+    rewind.first = (rewind.first + 1) % rewind.length;
+    rewind.count--;
+  }
+
+  memory::copy(rewind.arena.data() + offset, rewind.scratch.data(), size);
+  rewind.deltas[(rewind.first + rewind.count) % rewind.length] = {offset, size};
+  rewind.count++;
+  rewind.arenaHead = offset + size;
+}
+
+auto Program::rewindLoad() -> void {
+  serializer s{rewind.current.data(), (uint)rewind.current.size()};  //copies the snapshot as a serializer::Load
+
+  if(rewind.count) {
+    //step the full snapshot back to the one before it for the next rewind:
+    rewind.count--;
+    auto& newest = rewind.deltas[(rewind.first + rewind.count) % rewind.length];
+    rewindDecode(rewind.current.data(), rewind.arena.data() + newest.offset, newest.size);
+    rewind.arenaHead = newest.offset;
+  } else {
+    showMessage("Rewind history exhausted");
+    rewindReset();
+  }
+
+  emulator->unserialize(s);
+}
+
+//writes target ^ source as alternating (unchanged count, changed count, changed bytes) runs; counts are LEB128.
+//worst case output size is size * 3 / 2 plus a few bytes.
+auto Program::rewindEncode(const uint8_t* target, const uint8_t* source, uint size, uint8_t* output) -> uint {
+  auto writeCount = [&](uint8_t*& p, uint n) {
+    while(n >= 0x80) *p++ = 0x80 | (n & 0x7f), n >>= 7;
+    *p++ = n;
+  };
+
+  uint8_t* p = output;
+  uint offset = 0;
+  while(offset < size) {
+    uint start = offset;
+    while(offset + 8 <= size && memory::readl<8>(target + offset) == memory::readl<8>(source + offset)) offset += 8;
+    while(offset < size && target[offset] == source[offset]) offset++;
+    if(offset == size) break;  //trailing unchanged bytes are implied
+    writeCount(p, offset - start);
+
+    start = offset;
+    while(offset < size && target[offset] != source[offset]) offset++;
+    writeCount(p, offset - start);
+    for(uint n = start; n < offset; n++) *p++ = target[n] ^ source[n];
+  }
+  return p - output;
+}
+
+auto Program::rewindDecode(uint8_t* target, const uint8_t* input, uint size) -> void {
+  auto readCount = [&]() -> uint {
+    uint n = 0;
+    for(uint shift = 0;; shift += 7) {
+      uint8_t byte = *input++;
+      n |= (byte & 0x7f) << shift;
+      if(!(byte & 0x80)) return n;
+    }
+  };
+
+  auto end = input + size;
+  while(input < end) {
+    target += readCount();
+    uint changed = readCount();
+    for(uint n : range(changed)) *target++ ^= *input++;
+  }
 }
@@ -42,6 +42,9 @@ auto Program::scriptInit() -> void {
   int r = script.engine->SetMessageCallback(asFUNCTION(MessageCallback), 0, asCALL_CDECL);
   assert(r >= 0);
 
+  // Compile scripts to native code if enabled:
+  scriptJIT(settings.script.jit);
+
   // Let the emulator register its script definitions:
   emulator->registerScriptDefs();
 
@@ -108,3 +111,13 @@ auto Program::scriptUnload() -> void {
   emulator->unloadScript();
   scriptMessage("All scripts unloaded", true);
 }
+
+// takes effect the next time a script is loaded. Once installed, the JIT compiler stays with the engine since
+// functions that were compiled by it must be released by it:
+auto Program::scriptJIT(bool enable) -> void {
+  if (enable && !script.engine->GetJITCompiler()) {
+    script.engine->SetEngineProperty(asEP_INCLUDE_JIT_INSTRUCTIONS, true);
+    script.engine->SetJITCompiler(&script.jit);
+  }
+  script.jit.SetEnabled(enable);
+}
@@ -0,0 +1,144 @@
+//called from the emulation thread; blocks only when Capacity jobs are already pending.
+auto Program::stateWriterEnqueue(StateWriter::Job&& job) -> void {
+  std::unique_lock<std::mutex> lock(stateWriter.mutex);
+  if(!stateWriter.thread.joinable()) {
+    stateWriter.stopping = false;
+    stateWriter.thread = std::thread([&] { stateWriterMain(); });
+  }
+  stateWriter.changed.wait(lock, [&] { return stateWriter.jobs.size() < StateWriter::Capacity; });
+  stateWriter.jobs.append(move(job));
+  stateWriter.changed.notify_all();
+}
+
+auto Program::stateWriterMain() -> void {
+  std::unique_lock<std::mutex> lock(stateWriter.mutex);
+  while(true) {
+    stateWriter.changed.wait(lock, [&] { return stateWriter.jobs || stateWriter.stopping; });
+    if(!stateWriter.jobs) break;  //stopping, and all pending states have been written
+
+    auto job = stateWriter.jobs.takeFirst();
+    stateWriter.active = job.filename;
+    stateWriter.busy = true;
+    stateWriter.changed.notify_all();
+    lock.unlock();
+
+    auto result = stateWriterWrite(job);
+
+    lock.lock();
+    stateWriter.results.append(result);
+    stateWriter.active = {};
+    stateWriter.busy = false;
+    stateWriter.changed.notify_all();
+  }
+}
+
+//runs on the writer thread: must not touch the emulator or any UI state.
+auto Program::stateWriterWrite(StateWriter::Job& job) -> StateWriter::Result {
+  string prefix = Location::file(job.filename);
+  auto& s = job.state;
+  auto serializerRLE = Encode::RLE<1>({s.data(), s.size()});
+
+  vector<uint8_t> previewRLE;
+  if(job.preview) {
+    if(job.preview.width() != 256 || job.preview.height() != 240) job.preview.scale(256, 240, true);
+    previewRLE = Encode::RLE<2>({job.preview.data(), job.preview.size()});
+  }
+
+  vector<uint8_t> saveState;
+  saveState.resize(3 * sizeof(uint));
+  memory::writel<sizeof(uint)>(saveState.data() + 0 * sizeof(uint), State::Signature);
+  memory::writel<sizeof(uint)>(saveState.data() + 1 * sizeof(uint), serializerRLE.size());
+  memory::writel<sizeof(uint)>(saveState.data() + 2 * sizeof(uint), previewRLE.size());
+  saveState.append(serializerRLE);
+  saveState.append(previewRLE);
+
+  if(!job.archive) {
+    string location = {job.path, job.filename, ".bst"};
+    directory::create(Location::path(location));
+    if(!file::write(location, saveState)) {
+      return {job.filename, {"Unable to write [", prefix, "] to disk"}, false, job.notify};
+    }
+    return {job.filename, {"Saved [", prefix, "]"}, true, job.notify};
+  }
+
+  string location = {job.filename, ".bst"};
+
+  //append the new entry in place of the archive's central directory, unless more than half of the archive would be
+  //left holding superseded states:
+  if(file::exists(job.path)) {
+    Encode::ZIP output{job.path, true};
+    if(output) {
+      output.remove(location);
+      if(output.wasted() <= file::size(job.path) / 2) {
+        if(!output.append(location, saveState.data(), saveState.size()) || !output.close()) {
+          return {job.filename, {"Unable to write [", prefix, "] to disk"}, false, job.notify};
+        }
+        return {job.filename, {"Saved [", prefix, "]"}, true, job.notify};
+      }
+    }
+  }
+
+  //rewrite the archive, dropping superseded states:
+  struct State { string name; time_t timestamp; vector<uint8_t> memory; };
+  vector<State> states;
+
+  Decode::ZIP input;
+  if(input.open(job.path)) {
+    for(auto& file : input.file) {
+      if(!file.name.endsWith(".bst")) continue;
+      if(file.name == location) continue;
+      states.append({file.name, file.timestamp, input.extract(file)});
+    }
+  }
+  input.close();
+
+  Encode::ZIP output{job.path};
+  bool written = (bool)output;
+  for(auto& state : states) {
+    if(written) written = output.append(state.name, state.memory.data(), state.memory.size(), state.timestamp);
+  }
+  if(written) written = output.append(location, saveState.data(), saveState.size());
+  if(!output.close() || !written) {
+    return {job.filename, {"Unable to write [", prefix, "] to disk"}, false, job.notify};
+  }
+  return {job.filename, {"Saved [", prefix, "]"}, true, job.notify};
+}
+
+//called from Program::main() to report finished writes:
+auto Program::stateWriterPoll() -> void {
+  vector<StateWriter::Result> results;
+  {
+    std::lock_guard<std::mutex> lock(stateWriter.mutex);
+    if(!stateWriter.results) return;
+    results = move(stateWriter.results);
+    stateWriter.results.reset();
+  }
+
+  for(auto& result : results) {
+    if(result.notify || !result.saved) showMessage(result.message);  //failures are reported even for undo/redo states
+    if(!result.saved) continue;
+    if(result.filename.beginsWith("Quick/")) presentation.updateStateMenus();
+    stateManager.stateEvent(result.filename);
+  }
+}
+
+//waits until the given state (or every state, if none is given) has been written:
+auto Program::stateWriterFlush(string filename) -> void {
+  std::unique_lock<std::mutex> lock(stateWriter.mutex);
+  stateWriter.changed.wait(lock, [&] {
+    if(!filename) return !stateWriter.jobs && !stateWriter.busy;
+    if(stateWriter.busy && stateWriter.active == filename) return false;
+    return !stateWriter.jobs.find([&](auto& job) { return job.filename == filename; });
+  });
+}
+
+auto Program::stateWriterStop() -> void {
+  if(!stateWriter.thread.joinable()) return;
+  {
+    std::lock_guard<std::mutex> lock(stateWriter.mutex);
+    stateWriter.stopping = true;
+  }
+  stateWriter.changed.notify_all();
+  stateWriter.thread.join();
+  stateWriterPoll();
+}
@@ -3,6 +3,7 @@ const uint Program::State::Signature = 0x5a22'0000;
 auto Program::availableStates(string type) -> vector<State> {
   vector<State> result;
   if(!emulator->loaded()) return result;
+  stateWriterFlush();
 
   if(gamePath().endsWith("/")) {
     for(auto& file : directory::ifiles({statePath(), type}, "*.bst")) {
@@ -24,6 +25,8 @@ auto Program::availableStates(string type) -> vector<State> {
 
 auto Program::hasState(string filename) -> bool {
   if(!emulator->loaded()) return false;
+  //states in an archive share one file, and any pending write may rewrite it:
+  stateWriterFlush(gamePath().endsWith("/") ? filename : string{});
 
   if(gamePath().endsWith("/")) {
     return file::exists({statePath(), filename, ".bst"});
@@ -35,6 +38,7 @@ auto Program::hasState(string filename) -> bool {
 
 auto Program::loadStateData(string filename) -> vector<uint8_t> {
   if(!emulator->loaded()) return {};
+  stateWriterFlush(gamePath().endsWith("/") ? filename : string{});
 
   vector<uint8_t> memory;
   if(gamePath().endsWith("/")) {
@@ -72,86 +76,41 @@ auto Program::loadState(string filename) -> bool {
   }
 }
 
-auto Program::saveState(string filename) -> bool {
+//returns true once the state is queued; stateWriterPoll() reports whether it was written:
+auto Program::saveState(string filename, bool notify) -> bool {
   if(!emulator->loaded()) return false;
   string prefix = Location::file(filename);
 
   serializer s = emulator->serialize();
   if(!s.size()) return showMessage({"Failed to save [", prefix, "]"}), false;
-  auto serializerRLE = Encode::RLE<1>({s.data(), s.size()});
 
-  vector<uint8_t> previewRLE;
+  //compression and file I/O happen in stateWriterWrite():
+  StateWriter::Job job;
+  job.filename = filename;
+  job.path = statePath();
+  job.archive = !gamePath().endsWith("/");
+  job.notify = notify;
+  job.state = move(s);
   //this can be null if a state is captured before the first frame of video output after power/reset
   if(screenshot.data) {
-    image preview;
-    preview.transform(0, 15, 0x8000, 0x7c00, 0x03e0, 0x001f);
-    preview.copy(screenshot.data, screenshot.pitch, screenshot.width, screenshot.height);
-    if(preview.width() != 256 || preview.height() != 240) preview.scale(256, 240, true);
-    previewRLE = Encode::RLE<2>({preview.data(), preview.size()});
+    job.preview.transform(0, 15, 0x8000, 0x7c00, 0x03e0, 0x001f);
+    job.preview.copy(screenshot.data, screenshot.pitch, screenshot.width, screenshot.height);
   }
-
-  vector<uint8_t> saveState;
-  saveState.resize(3 * sizeof(uint));
-  memory::writel<sizeof(uint)>(saveState.data() + 0 * sizeof(uint), State::Signature);
-  memory::writel<sizeof(uint)>(saveState.data() + 1 * sizeof(uint), serializerRLE.size());
-  memory::writel<sizeof(uint)>(saveState.data() + 2 * sizeof(uint), previewRLE.size());
-  saveState.append(serializerRLE);
-  saveState.append(previewRLE);
-
-  if(gamePath().endsWith("/")) {
-    string location = {statePath(), filename, ".bst"};
-    directory::create(Location::path(location));
-    if(!file::write(location, saveState)) {
-      return showMessage({"Unable to write [", prefix, "] to disk"}), false;
-    }
-  } else {
-    string location = {filename, ".bst"};
-
-    struct State { string name; time_t timestamp; vector<uint8_t> memory; };
-    vector<State> states;
-
-    Decode::ZIP input;
-    if(input.open(statePath())) {
-      for(auto& file : input.file) {
-        if(!file.name.endsWith(".bst")) continue;
-        if(file.name == location) continue;
-        states.append({file.name, file.timestamp, input.extract(file)});
-      }
-    }
-    input.close();
-
-    Encode::ZIP output{statePath()};
-    for(auto& state : states) {
-      output.append(state.name, state.memory.data(), state.memory.size(), state.timestamp);
-    }
-    output.append(location, saveState.data(), saveState.size());
-  }
-
-  if(filename.beginsWith("Quick/")) presentation.updateStateMenus();
-  stateManager.stateEvent(filename);
-  return showMessage({"Saved [", prefix, "]"}), true;
+  stateWriterEnqueue(move(job));
+  return true;
 }
 
 auto Program::saveUndoState() -> bool {
-  auto statusTime = this->statusTime;
-  auto statusMessage = this->statusMessage;
-  auto result = saveState("Quick/Undo");
-  this->statusTime = statusTime;
-  this->statusMessage = statusMessage;
-  return result;
+  return saveState("Quick/Undo", false);
 }
 
 auto Program::saveRedoState() -> bool {
-  auto statusTime = this->statusTime;
-  auto statusMessage = this->statusMessage;
-  auto result = saveState("Quick/Redo");
-  this->statusTime = statusTime;
-  this->statusMessage = statusMessage;
-  return result;
+  return saveState("Quick/Redo", false);
 }
 
 auto Program::removeState(string filename) -> bool {
   if(!emulator->loaded()) return false;
+  stateWriterFlush();
   bool result = false;
 
   if(gamePath().endsWith("/")) {
@@ -195,6 +154,7 @@ auto Program::removeState(string filename) -> bool {
 
 auto Program::renameState(string from_, string to_) -> bool {
   if(!emulator->loaded()) return false;
+  stateWriterFlush();
   bool result = false;
 
   if(gamePath().endsWith("/")) {
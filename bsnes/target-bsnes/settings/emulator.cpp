@@ -114,12 +114,16 @@ auto EmulatorSettings::create() -> void {
   rewindLengthOption.append(ComboButtonItem().setText( "80 states"));
   rewindLengthOption.append(ComboButtonItem().setText("160 states"));
   rewindLengthOption.append(ComboButtonItem().setText("320 states"));
+  rewindLengthOption.append(ComboButtonItem().setText("640 states"));
+  rewindLengthOption.append(ComboButtonItem().setText("1280 states"));
   if(settings.rewind.length ==  10) rewindLengthOption.item(0).setSelected();
   if(settings.rewind.length ==  20) rewindLengthOption.item(1).setSelected();
   if(settings.rewind.length ==  40) rewindLengthOption.item(2).setSelected();
   if(settings.rewind.length ==  80) rewindLengthOption.item(3).setSelected();
   if(settings.rewind.length == 160) rewindLengthOption.item(4).setSelected();
   if(settings.rewind.length == 320) rewindLengthOption.item(5).setSelected();
+  if(settings.rewind.length == 640) rewindLengthOption.item(6).setSelected();
+  if(settings.rewind.length == 1280) rewindLengthOption.item(7).setSelected();
   rewindLengthOption.onChange([&] {
     settings.rewind.length = 10 << rewindLengthOption.selected().offset();
     program.rewindReset();
@@ -117,6 +117,7 @@ auto Settings::process(bool load) -> void {
   bind(boolean, "Emulator/AutoLoadStateOnLoad",          emulator.autoLoadStateOnLoad);
   bind(text,    "Emulator/Serialization/Method",         emulator.serialization.method);
   bind(natural, "Emulator/RunAhead/Frames",              emulator.runAhead.frames);
+  bind(text,    "Emulator/StateExport/Name",             emulator.stateExport.name);
   bind(boolean, "Emulator/Hack/Hotfixes",                emulator.hack.hotfixes);
   bind(text,    "Emulator/Hack/Entropy",                 emulator.hack.entropy);
   bind(natural, "Emulator/Hack/CPU/Overclock",           emulator.hack.cpu.overclock);
@@ -126,6 +127,7 @@ auto Settings::process(bool load) -> void {
   bind(boolean, "Emulator/Hack/PPU/NoSpriteLimit",       emulator.hack.ppu.noSpriteLimit);
   bind(boolean, "Emulator/Hack/PPU/NoVRAMBlocking",      emulator.hack.ppu.noVRAMBlocking);
   bind(natural, "Emulator/Hack/PPU/Threads",             emulator.hack.ppu.threads);
+  bind(natural, "Emulator/Hack/PPU/ThreadSpin",          emulator.hack.ppu.threadSpin);
   bind(natural, "Emulator/Hack/PPU/Mode7/Scale",         emulator.hack.ppu.mode7.scale);
   bind(boolean, "Emulator/Hack/PPU/Mode7/Perspective",   emulator.hack.ppu.mode7.perspective);
   bind(boolean, "Emulator/Hack/PPU/Mode7/Supersample",   emulator.hack.ppu.mode7.supersample);
@@ -139,6 +141,8 @@ auto Settings::process(bool load) -> void {
   bind(natural, "Emulator/Hack/SuperFX/Overclock",       emulator.hack.superfx.overclock);
   bind(boolean, "Emulator/Cheats/Enable",                emulator.cheats.enable);
 
+  bind(boolean, "Script/JIT", script.jit);
+
   bind(boolean, "General/StatusBar",         general.statusBar);
   bind(boolean, "General/ScreenSaver",       general.screenSaver);
   bind(boolean, "General/ToolTips",          general.toolTips);
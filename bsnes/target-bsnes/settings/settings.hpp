@@ -102,6 +102,9 @@ struct Settings : Markup::Node {
     struct RunAhead {
       uint frames = 0;
     } runAhead;
+    struct StateExport {
+      string name;
+    } stateExport;
     struct Hack {
       bool hotfixes = true;
       string entropy = "Low";
@@ -114,6 +117,7 @@ struct Settings : Markup::Node {
         bool deinterlace = true;
         bool noSpriteLimit = false;
         uint threads = 0;
+        uint threadSpin = 50;
         bool noVRAMBlocking = false;
         struct Mode7 {
           uint scale = 1;
@@ -143,6 +147,10 @@ struct Settings : Markup::Node {
     } cheats;
   } emulator;
 
+  struct Script {
+    bool jit = false;
+  } script;
+
   struct General {
     bool statusBar = true;
     bool screenSaver = false;
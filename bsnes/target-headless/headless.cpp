@@ -0,0 +1,418 @@
+#include <sfc/sfc.hpp>
+#include <nall/directory.hpp>
+using namespace nall;
+
+#include <heuristics/heuristics.hpp>
+#include <heuristics/heuristics.cpp>
+#include <heuristics/super-famicom.cpp>
+
+#include "../target-bsnes/resource/resource.hpp"
+
+// runs a game and an optional script for a fixed number of frames with no video, audio or input, then reports
+// per-frame timings. used to track performance regressions in the core and the script bridge.
+
+static Emulator::Interface *emulator;
+
+struct Program : Emulator::Platform {
+  Program();
+
+  auto open(uint id, string name, vfs::file::mode mode, bool required) -> shared_pointer<vfs::file> override;
+  auto load(uint id, string name, string type, vector<string> options = {}) -> Emulator::Platform::Load override;
+  auto videoFrame(const uint16* data, uint pitch, uint width, uint height, uint scale) -> void override;
+  auto scriptEngine() -> asIScriptEngine* override;
+  auto scriptMessage(const string& msg, bool alert = false) -> void override;
+
+  auto loadSuperFamicom(string location) -> bool;
+  auto runFrame() -> void;
+
+  struct SuperFamicom {
+    string location;
+    string manifest;
+    string title;
+    string region;
+    vector<uint8_t> program;
+    vector<uint8_t> data;
+    vector<uint8_t> expansion;
+  } superFamicom;
+
+  asIScriptEngine *engine = nullptr;
+  CScriptJIT jit;
+  bool msuStream = false;
+  bool frameComplete = false;
+};
+
+Program::Program() {
+  platform = this;
+}
+
+auto Program::open(uint id, string name, vfs::file::mode mode, bool required) -> shared_pointer<vfs::file> {
+  if(mode != vfs::file::mode::read) return {};
+
+  if(name == "ipl.rom") {
+    return vfs::memory::file::open(Resource::System::IPLROM, sizeof(Resource::System::IPLROM));
+  }
+  if(name == "boards.bml") {
+    return vfs::memory::file::open(Resource::System::Boards, sizeof(Resource::System::Boards));
+  }
+
+  if(id == ::SuperFamicom::ID::SuperFamicom) {
+    if(name == "manifest.bml") {
+      return vfs::memory::file::open(superFamicom.manifest.data<uint8_t>(), superFamicom.manifest.size());
+    }
+    if(name == "program.rom") {
+      return vfs::memory::file::open(superFamicom.program.data(), superFamicom.program.size());
+    }
+    if(name == "data.rom") {
+      return vfs::memory::file::open(superFamicom.data.data(), superFamicom.data.size());
+    }
+    if(name == "expansion.rom") {
+      return vfs::memory::file::open(superFamicom.expansion.data(), superFamicom.expansion.size());
+    }
+    // MSU-1 files are memory-mapped unless --msu-stream asks for the background read-ahead the core falls back to:
+    string location;
+    if(name == "msu1/data.rom") location = {Location::notsuffix(superFamicom.location), ".msu"};
+    if(name.match("msu1/track-*.pcm")) location = {Location::notsuffix(superFamicom.location), name.trimLeft("msu1/track", 1L)};
+    if(location) {
+      if(!msuStream) return vfs::fs::file_map::open(location);
+      return vfs::fs::file::open(location, mode);
+    }
+  }
+
+  if(required) scriptMessage({"missing required file: ", name});
+  return {};
+}
+
+auto Program::load(uint id, string name, string type, vector<string> options) -> Emulator::Platform::Load {
+  if(id == ::SuperFamicom::ID::SuperFamicom) {
+    return {id, superFamicom.region};
+  }
+  return {};
+}
+
+auto Program::videoFrame(const uint16* data, uint pitch, uint width, uint height, uint scale) -> void {
+  frameComplete = true;
+}
+
+auto Program::scriptEngine() -> asIScriptEngine* {
+  return engine;
+}
+
+auto Program::scriptMessage(const string& msg, bool alert) -> void {
+  printf("%.*s\n", msg.size(), msg.data());
+}
+
+static void MessageCallback(const asSMessageInfo *msg, void *param) {
+  const char *type = "ERR ";
+  if (msg->type == asMSGTYPE_WARNING)
+    type = "WARN";
+  else if (msg->type == asMSGTYPE_INFORMATION)
+    type = "INFO";
+  platform->scriptMessage(string("{0} ({1}, {2}) : {3} : {4}").format({msg->section, msg->row, msg->col, type, msg->message}));
+}
+
+auto Program::loadSuperFamicom(string location) -> bool {
+  auto rom = file::read(location);
+  if(rom.size() < 0x8000) return false;
+
+  if((rom.size() & 0x7fff) == 512) {
+    //remove copier header
+    memory::move(&rom[0], &rom[512], rom.size() - 512);
+    rom.resize(rom.size() - 512);
+  }
+
+  auto heuristics = Heuristics::SuperFamicom(rom, location);
+  auto sha256 = Hash::SHA256(rom).digest();
+  superFamicom.title = heuristics.title();
+  superFamicom.region = heuristics.videoRegion();
+  superFamicom.manifest = heuristics.manifest();
+  if(auto document = BML::unserialize(string::read({Path::program(), "Database/Super Famicom.bml"}))) {
+    if(auto game = document[{"game(sha256=", sha256, ")"}]) {
+      superFamicom.manifest = BML::serialize(game);
+      //the internal ROM header title is not present in the database, but is needed for internal core overrides
+      superFamicom.manifest.append("  title: ", superFamicom.title, "\n");
+    }
+  }
+  superFamicom.location = location;
+
+  uint offset = 0;
+  if(auto size = heuristics.programRomSize()) {
+    superFamicom.program.resize(size);
+    memory::copy(&superFamicom.program[0], &rom[offset], size);
+    offset += size;
+  }
+  if(auto size = heuristics.dataRomSize()) {
+    superFamicom.data.resize(size);
+    memory::copy(&superFamicom.data[0], &rom[offset], size);
+    offset += size;
+  }
+  if(auto size = heuristics.expansionRomSize()) {
+    superFamicom.expansion.resize(size);
+    memory::copy(&superFamicom.expansion[0], &rom[offset], size);
+    offset += size;
+  }
+
+  return true;
+}
+
+// emulator->run() returns on every scheduler event; a frame is complete once it has been presented:
+auto Program::runFrame() -> void {
+  frameComplete = false;
+  while(!frameComplete) emulator->run();
+}
+
+struct Samples {
+  string name;
+  vector<uint64> values;
+
+  auto percentile(uint p) const -> uint64 {
+    if(!values) return 0;
+    return values[min(values.size() - 1, values.size() * p / 100)];
+  }
+
+  auto total() const -> uint64 {
+    uint64 sum = 0;
+    for(auto value : values) sum += value;
+    return sum;
+  }
+
+  auto text() const -> string {
+    return {
+      pad(name, -10), "  ",
+      pad(percentile(50) / 1000, 8), "  ",
+      pad(percentile(95) / 1000, 8), "  ",
+      pad(percentile(99) / 1000, 8), "  ",
+      pad(values ? values.last() / 1000 : 0, 8), "\n"
+    };
+  }
+
+  auto json() const -> string {
+    return {
+      "\"", name, "\": {",
+      "\"p50_ns\": ", percentile(50), ", ",
+      "\"p95_ns\": ", percentile(95), ", ",
+      "\"p99_ns\": ", percentile(99), ", ",
+      "\"max_ns\": ", values ? values.last() : 0, ", ",
+      "\"total_ns\": ", total(),
+      "}"
+    };
+  }
+};
+
+static auto escape(string text) -> string {
+  return text.replace("\\", "\\\\").replace("\"", "\\\"");
+}
+
+#if defined(EMULATOR_INSTANCES)
+// runs the game on several consoles at once, one per thread, and reports the combined frame rate along with a
+// checksum of each console's WRAM. consoles start without entropy and run without input, so the checksums match
+// unless the consoles interfere with each other:
+static auto runInstances(const Program& source, uint count, uint frames) -> void {
+  vector<Program*> programs;
+  programs.resize(count);
+  vector<bool> loaded;
+  loaded.resize(count);
+
+  SuperFamicom::InstancePool pool;
+  pool.create(count);
+  pool.run([&](uint index) {
+    // the Program constructor makes it the platform of this thread's console:
+    auto program = programs[index] = new Program;
+    program->superFamicom = source.superFamicom;
+    program->msuStream = source.msuStream;
+    auto& interface = SuperFamicom::Instance::active().interface;
+    if(loaded[index] = interface.load()) interface.power();
+  });
+
+  auto benchmarkStart = chrono::nanosecond();
+  pool.step(frames);
+  uint64 benchmarkTime = chrono::nanosecond() - benchmarkStart;
+
+  vector<uint32_t> checksums;
+  checksums.resize(count);
+  pool.run([&](uint index) {
+    checksums[index] = Hash::CRC32({SuperFamicom::cpu.wram, sizeof(SuperFamicom::cpu.wram)}).value();
+    if(loaded[index]) SuperFamicom::Instance::active().interface.unload();
+  });
+  pool.destroy();
+
+  string text;
+  text.append("game:      ", source.superFamicom.title, "\n");
+  text.append("instances: ", count, "\n");
+  text.append("frames:    ", frames, " each in ", benchmarkTime / 1000000, " ms (", count * frames * 1000000000ull / (benchmarkTime ? benchmarkTime : 1), " fps combined)\n");
+  for(uint index : range(count)) {
+    text.append("  ", pad(index, 3), "  ", loaded[index] ? hex(checksums[index], 8L) : string{"not loaded"}, "\n");
+  }
+  print(text);
+
+  for(auto program : programs) delete program;
+}
+#endif
+
+#include <nall/main.hpp>
+auto nall::main(Arguments arguments) -> void {
+  string romLocation;
+  string scriptLocation;
+  string jsonLocation = "headless.json";
+  uint frames = 600;
+  uint threads = 0;
+  bool jit = false;
+  string exportName;
+  uint instances = 0;
+  bool msuStream = false;
+
+  for(auto argument : arguments) {
+    if(argument.beginsWith("--rom=")) {
+      romLocation = argument.trimLeft("--rom=", 1L);
+    } else if(argument.beginsWith("--script=")) {
+      scriptLocation = argument.trimLeft("--script=", 1L);
+    } else if(argument.beginsWith("--frames=")) {
+      frames = argument.trimLeft("--frames=", 1L).natural();
+    } else if(argument.beginsWith("--threads=")) {
+      threads = argument.trimLeft("--threads=", 1L).natural();
+    } else if(argument == "--jit") {
+      jit = true;
+    } else if(argument.beginsWith("--export=")) {
+      exportName = argument.trimLeft("--export=", 1L);
+    } else if(argument == "--msu-stream") {
+      msuStream = true;
+    } else if(argument.beginsWith("--instances=")) {
+      instances = argument.trimLeft("--instances=", 1L).natural();
+    } else if(argument.beginsWith("--json=")) {
+      jsonLocation = argument.trimLeft("--json=", 1L);
+    }
+  }
+
+  if(!romLocation || !frames) {
+    print("usage: bsnes-headless --rom=game.sfc [--script=path] [--frames=600] [--threads=0] [--jit] [--export=name] [--json=headless.json] [--instances=n] [--msu-stream]\n");
+    return;
+  }
+
+  Program program;
+  program.msuStream = msuStream;
+  if(!program.loadSuperFamicom(romLocation)) {
+    print("unable to load ROM '", romLocation, "'\n");
+    return;
+  }
+
+  if(instances) {
+#if defined(EMULATOR_INSTANCES)
+    // configuration is shared by all consoles; each of them renders on its own thread:
+    SuperFamicom::configuration.hacks.ppu.threads = 0;
+    SuperFamicom::configuration.hacks.entropy = "None";
+    runInstances(program, instances, frames);
+#else
+    print("--instances requires a build with instances=true\n");
+#endif
+    return;
+  }
+
+  emulator = new SuperFamicom::Interface;
+  emulator->configure("Hacks/PPU/Threads", threads);
+  emulator->configure("StateExport/Name", exportName);
+
+  program.engine = asCreateScriptEngine();
+  int r = program.engine->SetMessageCallback(asFUNCTION(MessageCallback), 0, asCALL_CDECL);
+  assert(r >= 0);
+  if(jit) {
+    program.engine->SetEngineProperty(asEP_INCLUDE_JIT_INSTRUCTIONS, true);
+    program.engine->SetJITCompiler(&program.jit);
+  }
+  emulator->registerScriptDefs();
+
+  if(!emulator->load()) {
+    print("unable to load ROM '", romLocation, "'\n");
+    delete emulator;
+    return;
+  }
+  emulator->power();
+
+  if(scriptLocation) {
+    if(directory::exists(scriptLocation) && !scriptLocation.endsWith("/")) scriptLocation.append("/");
+    if(!inode::exists(scriptLocation)) {
+      print("script '", scriptLocation, "' not found\n");
+      delete emulator;
+      return;
+    }
+    emulator->loadScript(scriptLocation);
+  }
+
+  bool fastPPU = SuperFamicom::system.fastPPU();
+  SuperFamicom::ScriptInterface::profileEnable(true);
+  SuperFamicom::ppufast.statistics.enabled = fastPPU;
+
+  Samples frame{"frame"};
+  Samples emulation{"emulation"};
+  Samples render{"render"};
+  Samples script{"script"};
+
+  auto benchmarkStart = chrono::nanosecond();
+  while(frame.values.size() < frames) {
+    auto scriptStart = SuperFamicom::ScriptInterface::profileNanoseconds();
+    auto renderStart = SuperFamicom::ppufast.statistics.renderNanoseconds.load();
+    auto frameStart = chrono::nanosecond();
+
+    program.runFrame();
+
+    uint64 frameTime = chrono::nanosecond() - frameStart;
+    uint64 scriptTime = SuperFamicom::ScriptInterface::profileNanoseconds() - scriptStart;
+    uint64 renderTime = SuperFamicom::ppufast.statistics.renderNanoseconds.load() - renderStart;
+
+    frame.values.append(frameTime);
+    script.values.append(scriptTime);
+    render.values.append(renderTime);
+    emulation.values.append(frameTime > scriptTime ? frameTime - scriptTime : 0);
+  }
+  uint64 benchmarkTime = chrono::nanosecond() - benchmarkStart;
+
+  SuperFamicom::ppufast.statistics.enabled = false;
+  emulator->unloadScript();
+  emulator->unload();
+
+  for(auto samples : {&frame, &emulation, &render, &script}) samples->values.sort();
+
+  //render time is summed across PPU render threads and overlaps emulation; it is zero for the accurate PPU.
+  string text;
+  text.append("game:   ", program.superFamicom.title, " (", Location::file(romLocation), ")\n");
+  text.append("script: ", scriptLocation ? scriptLocation : string{"(none)"}, "\n");
+  text.append("ppu:    ", fastPPU ? "fast" : "accurate", "\n");
+  if(jit) {
+    uint native = program.jit.GetCompiledInstructionCount();
+    uint interpreted = program.jit.GetInterpretedInstructionCount();
+    text.append("jit:    ", program.jit.GetCompiledFunctionCount(), " functions, ", native, " of ", native + interpreted, " instructions native\n");
+  }
+  text.append("frames: ", frames, " in ", benchmarkTime / 1000000, " ms (", frames * 1000000000ull / (benchmarkTime ? benchmarkTime : 1), " fps)\n");
+  auto& msu = SuperFamicom::msu1.statistics;
+  if(msu.seeks) {
+    text.append("msu1:   ", msu.seeks, " track seeks (", msuStream ? "streamed" : "mapped", "), ",
+      msu.totalNs / msu.seeks / 1000, " us average, ", msu.maxNs / 1000, " us max\n");
+  }
+  text.append("               p50 us    p95 us    p99 us    max us\n");
+  for(auto samples : {&frame, &emulation, &render, &script}) text.append(samples->text());
+  print(text);
+
+  string json;
+  json.append("{\n");
+  json.append("  \"game\": \"", escape(program.superFamicom.title), "\",\n");
+  json.append("  \"rom\": \"", escape(Location::file(romLocation)), "\",\n");
+  json.append("  \"script\": \"", escape(scriptLocation), "\",\n");
+  json.append("  \"ppu\": \"", fastPPU ? "fast" : "accurate", "\",\n");
+  json.append("  \"frames\": ", frames, ",\n");
+  json.append("  \"threads\": ", threads, ",\n");
+  json.append("  \"jit\": ", jit ? "true" : "false", ",\n");
+  json.append("  \"total_ns\": ", benchmarkTime, ",\n");
+  if(msu.seeks) {
+    json.append("  \"msu1\": {\"seeks\": ", msu.seeks, ", \"streamed\": ", msuStream ? "true" : "false", ", ");
+    json.append("\"average_ns\": ", msu.totalNs / msu.seeks, ", \"max_ns\": ", msu.maxNs, "},\n");
+  }
+  json.append("  ", frame.json(), ",\n");
+  json.append("  ", emulation.json(), ",\n");
+  json.append("  ", render.json(), ",\n");
+  json.append("  ", script.json(), "\n");
+  json.append("}\n");
+  if(!file::write(jsonLocation, json)) {
+    print("unable to write '", jsonLocation, "'\n");
+  }
+
+  delete emulator;
+  program.engine->ShutDownAndRelease();
+}
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <nall/simd.hpp>
 #include <nall/dsp/dsp.hpp>
 
 //transposed direct form II biquadratic second-order IIR filter
@@ -19,6 +20,8 @@ struct Biquad {
 
   inline auto reset(Type type, double cutoffFrequency, double samplingFrequency, double quality, double gain = 0.0) -> void;
   inline auto process(double in) -> double;  //normalized sample (-1.0 to +1.0)
+  inline auto process(double* samples, uint count, uint stride = 1) -> void;
+  inline static auto process(Biquad& left, Biquad& right, double* samples, uint count) -> void;
 
   inline static auto shelf(double gain, double slope) -> double;
   inline static auto butterworth(uint order, uint phase) -> double;
@@ -150,6 +153,44 @@ auto Biquad::process(double in) -> double {
   return out;
 }
 
+//filters count samples in place, which are stride samples apart
+auto Biquad::process(double* samples, uint count, uint stride) -> void {
+  for(uint n : range(count)) {
+    double in = samples[n * stride];
+    double out = in * a0 + z1;
+    z1 = in * a1 + z2 - b1 * out;
+    z2 = in * a2 - b2 * out;
+    samples[n * stride] = out;
+  }
+}
+
+//filters count interleaved stereo frames in place: left filters the first channel, right the second
+auto Biquad::process(Biquad& left, Biquad& right, double* samples, uint count) -> void {
+  #if defined(SIMD_SSE2)
+  __m128d a0 = _mm_set_pd(right.a0, left.a0);
+  __m128d a1 = _mm_set_pd(right.a1, left.a1);
+  __m128d a2 = _mm_set_pd(right.a2, left.a2);
+  __m128d b1 = _mm_set_pd(right.b1, left.b1);
+  __m128d b2 = _mm_set_pd(right.b2, left.b2);
+  __m128d z1 = _mm_set_pd(right.z1, left.z1);
+  __m128d z2 = _mm_set_pd(right.z2, left.z2);
+  for(uint n : range(count)) {
+    __m128d in = _mm_loadu_pd(samples + n * 2);
+    __m128d out = _mm_add_pd(_mm_mul_pd(in, a0), z1);
+    z1 = _mm_sub_pd(_mm_add_pd(_mm_mul_pd(in, a1), z2), _mm_mul_pd(b1, out));
+    z2 = _mm_sub_pd(_mm_mul_pd(in, a2), _mm_mul_pd(b2, out));
+    _mm_storeu_pd(samples + n * 2, out);
+  }
+  _mm_storel_pd(&left.z1, z1);
+  _mm_storeh_pd(&right.z1, z1);
+  _mm_storel_pd(&left.z2, z2);
+  _mm_storeh_pd(&right.z2, z2);
+  #else
+  left.process(samples + 0, count, 2);
+  right.process(samples + 1, count, 2);
+  #endif
+}
+
 //compute Q values for low-shelf and high-shelf filtering
 auto Biquad::shelf(double gain, double slope) -> double {
   double a = pow(10, gain / 40);
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <nall/simd.hpp>
 #include <nall/queue.hpp>
 #include <nall/serializer.hpp>
 #include <nall/dsp/dsp.hpp>
@@ -15,6 +16,8 @@ struct Cubic {
   inline auto pending() const -> bool;
   inline auto read() -> double;
   inline auto write(double sample) -> void;
+  inline auto write(const double* samples, uint count, uint stride = 1) -> void;
+  inline static auto write(Cubic& left, Cubic& right, const double* samples, uint count) -> void;
   inline auto serialize(serializer&) -> void;
 
 private:
@@ -72,6 +75,59 @@ auto Cubic::write(double sample) -> void {
   mu -= 1.0;
 }
 
+//writes count samples, which are stride samples apart
+auto Cubic::write(const double* samples, uint count, uint stride) -> void {
+  for(uint n : range(count)) write(samples[n * stride]);
+}
+
+//writes count interleaved stereo frames: left resamples the first channel, right the second.
+//both channels are interpolated at once as long as they are at the same position
+auto Cubic::write(Cubic& left, Cubic& right, const double* samples, uint count) -> void {
+  #if defined(SIMD_SSE2)
+  if(left._ratio == right._ratio && left._fraction == right._fraction) {
+    auto mu = left._fraction;
+    __m128d s0 = _mm_set_pd(right._history[0], left._history[0]);
+    __m128d s1 = _mm_set_pd(right._history[1], left._history[1]);
+    __m128d s2 = _mm_set_pd(right._history[2], left._history[2]);
+    __m128d s3 = _mm_set_pd(right._history[3], left._history[3]);
+
+    for(uint n : range(count)) {
+      s0 = s1;
+      s1 = s2;
+      s2 = s3;
+      s3 = _mm_loadu_pd(samples + n * 2);
+
+      __m128d A = _mm_add_pd(_mm_sub_pd(_mm_sub_pd(s3, s2), s0), s1);
+      __m128d B = _mm_sub_pd(_mm_sub_pd(s0, s1), A);
+      __m128d C = _mm_sub_pd(s2, s0);
+      __m128d D = s1;
+
+      while(mu <= 1.0) {
+        __m128d m = _mm_set1_pd(mu);
+        __m128d a = _mm_mul_pd(_mm_mul_pd(_mm_mul_pd(A, m), m), m);
+        __m128d b = _mm_mul_pd(_mm_mul_pd(B, m), m);
+        __m128d out = _mm_add_pd(_mm_add_pd(_mm_add_pd(a, b), _mm_mul_pd(C, m)), D);
+        left._samples.write(_mm_cvtsd_f64(out));
+        right._samples.write(_mm_cvtsd_f64(_mm_unpackhi_pd(out, out)));
+        mu += left._ratio;
+      }
+
+      mu -= 1.0;
+    }
+
+    _mm_storel_pd(&left._history[0], s0), _mm_storeh_pd(&right._history[0], s0);
+    _mm_storel_pd(&left._history[1], s1), _mm_storeh_pd(&right._history[1], s1);
+    _mm_storel_pd(&left._history[2], s2), _mm_storeh_pd(&right._history[2], s2);
+    _mm_storel_pd(&left._history[3], s3), _mm_storeh_pd(&right._history[3], s3);
+    left._fraction = mu;
+    right._fraction = mu;
+    return;
+  }
+  #endif
+  left.write(samples + 0, count, 2);
+  right.write(samples + 1, count, 2);
+}
+
 auto Cubic::serialize(serializer& s) -> void {
   s.real(_inputFrequency);
   s.real(_outputFrequency);
@@ -13,9 +13,42 @@ struct ZIP {
     timestamp = time(nullptr);
   }
 
+  //reopens an archive written by this class: new entries are written over the old central directory, and removed
+  //entries are only dropped from the directory. check operator bool: archives with compressed entries, extra fields
+  //or a comment are not supported.
+  ZIP(const string& filename, bool append) {
+    timestamp = time(nullptr);
+    if(!append) {
+      fp.open(filename, file::mode::write);
+    } else if(!reopen(filename)) {
+      fp.close();
+    }
+  }
+
+  explicit operator bool() const {
+    return (bool)fp;
+  }
+
+  //bytes of file data no longer referenced by the directory:
+  auto wasted() const -> uint64_t {
+    return wastedBytes;
+  }
+
+  auto remove(const string& filename) -> bool {
+    for(uint n : range(directory.size())) {
+      if(directory[n].filename != filename) continue;
+      wastedBytes += 30 + directory[n].filename.length() + directory[n].size;
+      directory.remove(n);
+      return true;
+    }
+    return false;
+  }
+
   //append path: append("path/");
   //append file: append("path/file", data, size);
-  auto append(string filename, const uint8_t* data = nullptr, uint size = 0u, time_t timestamp = 0) -> void {
+  //returns false if the entry could not be written to disk
+  auto append(string filename, const uint8_t* data = nullptr, uint size = 0u, time_t timestamp = 0) -> bool {
+    if(!fp) return false;
     filename.transform("\\", "/");
     if(!timestamp) timestamp = this->timestamp;
     uint32_t checksum = Hash::CRC32({data, size}).digest().hex();
@@ -35,9 +68,18 @@ struct ZIP {
     fp.print(filename);               //file name
 
     fp.write({data, size});           //file data
+    fp.flush();
+    return !fp.failed();
   }
 
   ~ZIP() {
+    close();
+  }
+
+  //writes the central directory; returns false if the archive could not be written to disk
+  auto close() -> bool {
+    if(!fp) return false;
+
     //central directory
     uint baseOffset = fp.offset();
     for(auto& entry : directory) {
@@ -72,7 +114,16 @@ struct ZIP {
     fp.writel(baseOffset, 4);                 //offset of central directory
     fp.writel(0x0000, 2);                     //comment length
 
+    //the previous directory may have extended past the new end of the archive:
+    if(appending) {
+      fp.flush();
+      if(!fp.truncate(fp.offset())) {
+        fp.close();
+        return false;
+      }
+    }
     fp.close();
+    return !fp.failed();
   }
 
 protected:
@@ -86,8 +137,61 @@ protected:
     return ((info->tm_year - 80) << 9) | ((1 + info->tm_mon) << 5) + (info->tm_mday);
   }
 
+  auto reopen(const string& filename) -> bool {
+    if(!fp.open(filename, file::mode::modify) || fp.size() < 22) return false;
+
+    fp.seek(fp.size() - 22);
+    if(fp.readl<uint32_t>(4) != 0x06054b50) return false;
+    fp.seek(fp.size() - 22 + 10);
+    uint count = fp.readl<uint16_t>(2);
+    fp.seek(fp.size() - 22 + 16);
+    uint baseOffset = fp.readl<uint32_t>(4);
+    if(fp.readl<uint16_t>(2) != 0) return false;  //comment length
+
+    uint64_t used = 0;
+    fp.seek(baseOffset);
+    for(uint n = 0; n < count; n++) {
+      if(fp.readl<uint32_t>(4) != 0x02014b50) return false;
+      fp.seek(6, file_buffer::index::relative);
+      if(fp.readl<uint16_t>(2) != 0) return false;  //compression method
+      uint16_t dosTime = fp.readl<uint16_t>(2);
+      uint16_t dosDate = fp.readl<uint16_t>(2);
+      entry_t entry;
+      entry.checksum = fp.readl<uint32_t>(4);
+      fp.seek(4, file_buffer::index::relative);
+      entry.size = fp.readl<uint32_t>(4);
+      uint nameLength = fp.readl<uint16_t>(2);
+      uint extraLength = fp.readl<uint16_t>(2);
+      uint commentLength = fp.readl<uint16_t>(2);
+      if(extraLength || commentLength) return false;
+      fp.seek(8, file_buffer::index::relative);
+      entry.offset = fp.readl<uint32_t>(4);
+      entry.filename = fp.reads(nameLength);
+
+      tm info = {};
+      info.tm_sec  = (dosTime >>  0 &  31) << 1;
+      info.tm_min  = (dosTime >>  5 &  63);
+      info.tm_hour = (dosTime >> 11 &  31);
+      info.tm_mday = (dosDate >>  0 &  31);
+      info.tm_mon  = (dosDate >>  5 &  15) - 1;
+      info.tm_year = (dosDate >>  9 & 127) + 80;
+      info.tm_isdst = -1;
+      entry.timestamp = mktime(&info);
+
+      used += 30 + nameLength + entry.size;
+      directory.append(entry);
+    }
+
+    wastedBytes = baseOffset > used ? baseOffset - used : 0;
+    fp.seek(baseOffset);
+    appending = true;
+    return true;
+  }
+
   file_buffer fp;
   time_t timestamp;
+  bool appending = false;
+  uint64_t wastedBytes = 0;
   struct entry_t {
     string filename;
     time_t timestamp;
@@ -41,6 +41,7 @@ struct file_buffer {
     fileOffset = source.fileOffset;
     fileSize = source.fileSize;
     fileMode = source.fileMode;
+    fileError = source.fileError;
 
     source.bufferOffset = -1;
     source.bufferDirty = false;
@@ -48,6 +49,7 @@ struct file_buffer {
     source.fileOffset = 0;
     source.fileSize = 0;
     source.fileMode = mode::read;
+    source.fileError = false;
 
     return *this;
   }
@@ -56,6 +58,11 @@ struct file_buffer {
     return (bool)fileHandle;
   }
 
+  //true if any write since open() failed to reach the file (checked when the buffer is flushed):
+  auto failed() const -> bool {
+    return fileError;
+  }
+
   auto read() -> uint8_t {
     if(!fileHandle) return 0;              //file not open
     if(fileMode == mode::write) return 0;  //reads not permitted
@@ -129,7 +136,7 @@ struct file_buffer {
 
   auto flush() -> void {
     bufferFlush();
-    fflush(fileHandle);
+    if(fileHandle && fflush(fileHandle) != 0) fileError = true;
   }
 
   auto seek(int64_t offset, uint index_ = index::absolute) -> void {
@@ -199,6 +206,7 @@ struct file_buffer {
 
     bufferOffset = -1;
     fileOffset = 0;
+    fileError = false;
     fseek(fileHandle, 0, SEEK_END);
     fileSize = ftell(fileHandle);
     fseek(fileHandle, 0, SEEK_SET);
@@ -208,7 +216,7 @@ struct file_buffer {
   auto close() -> void {
     if(!fileHandle) return;
     bufferFlush();
-    fclose(fileHandle);
+    if(fclose(fileHandle) != 0) fileError = true;
     fileHandle = nullptr;
   }
 
@@ -220,6 +228,7 @@ private:
   uint64_t fileOffset = 0;
   uint64_t fileSize = 0;
   uint fileMode = mode::read;
+  bool fileError = false;
 
   auto bufferSynchronize() -> void {
     if(!fileHandle) return;
@@ -240,7 +249,7 @@ private:
 
     fseek(fileHandle, bufferOffset, SEEK_SET);
     uint64_t length = bufferOffset + buffer.size() <= fileSize ? buffer.size() : fileSize & buffer.size() - 1;
-    if(length) (void)fwrite(buffer.data(), 1, length, fileHandle);
+    if(length && fwrite(buffer.data(), 1, length, fileHandle) != length) fileError = true;
     bufferOffset = -1;
     bufferDirty = false;
   }
@@ -26,6 +26,11 @@ struct shared_memory {
     return _acquired;
   }
 
+  //access without the semaphore, for users that synchronize on their own:
+  auto data() -> uint8_t* {
+    return _data;
+  }
+
   auto acquire() -> uint8_t* {
     if(!acquired()) {
       sem_wait(_semaphore);
@@ -90,7 +95,7 @@ struct shared_memory {
     }
 
     _mode = mode::inactive;
-    _name = "";
+    _name.reset();
     _size = 0;
   }
 
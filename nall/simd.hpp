@@ -1,11 +1,12 @@
 #pragma once
 
-namespace nall {
-
 #if defined(__AVX2__)
   #define SIMD 256
   #define SIMD_AVX2
+  #define SIMD_SSE2
   #include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+  #define SIMD 128
+  #define SIMD_SSE2
+  #include <emmintrin.h>
 #endif
-
-}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <nall/file-map.hpp>
+
+namespace nall::vfs::fs {
+
+//a read-only file that is memory-mapped, so that data() exposes its contents without copying them:
+struct file_map : vfs::file {
+  static auto open(string location_) -> shared_pointer<vfs::file> {
+    auto instance = shared_pointer<file_map>{new file_map};
+    if(!instance->_open(location_)) return {};
+    return instance;
+  }
+
+  auto data() const -> const uint8_t* override {
+    return _map.data();
+  }
+
+  auto size() const -> uintmax override {
+    return _map.size();
+  }
+
+  auto offset() const -> uintmax override {
+    return _offset;
+  }
+
+  auto seek(intmax offset_, index index_) -> void override {
+    if(index_ == index::absolute) _offset = (uintmax)offset_;
+    if(index_ == index::relative) _offset += (intmax)offset_;
+  }
+
+  auto read() -> uint8_t override {
+    if(_offset >= size()) return 0x00;
+    return _map.data()[_offset++];
+  }
+
+  auto write(uint8_t data_) -> void override {
+  }
+
+private:
+  file_map() = default;
+  file_map(const file_map&) = delete;
+  auto operator=(const file_map&) -> file_map& = delete;
+
+  auto _open(string location_) -> bool {
+    if(!_map.open(location_, nall::file_map::mode::read)) return false;
+    return _map.size() == 0 || _map.data();
+  }
+
+  nall::file_map _map;
+  uintmax _offset = 0;
+};
+
+}
@@ -11,6 +11,8 @@ struct file {
 
   virtual ~file() = default;
 
+  //the contents of files that are held in memory as a whole, nullptr otherwise:
+  virtual auto data() const -> const uint8_t* { return nullptr; }
   virtual auto size() const -> uintmax = 0;
   virtual auto offset() const -> uintmax = 0;
 
@@ -68,4 +70,5 @@ struct file {
 }
 
 #include <nall/vfs/fs/file.hpp>
+#include <nall/vfs/fs/file-map.hpp>
 #include <nall/vfs/memory/file.hpp>
@@ -15,6 +15,7 @@ struct shared_memory {
   auto empty() const -> bool { return true; }
   auto size() const -> uint { return 0; }
   auto acquired() const -> bool { return false; }
+  auto data() -> uint8_t* { return nullptr; }
   auto acquire() -> uint8_t* { return nullptr; }
   auto release() -> void {}
   auto reset() -> void {}
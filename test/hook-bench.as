@@ -0,0 +1,57 @@
+// benchmark script to measure how many interceptor calls per second the script bridge can sustain.
+// run the same game and script on two builds to compare before and after; disable the speed limiter (fast forward)
+// so that the emulator runs as fast as the hooks allow.
+// WRAM writes to the stack and direct page happen thousands of times per frame in nearly every game, which makes them
+// a good source of hook calls. A pc interceptor is registered on an instruction that performed one of those writes so
+// that pc and write hooks alternate with each other.
+
+uint64 writeHooks = 0;
+uint64 pcHooks = 0;
+
+uint frames = 0;
+uint64 startTime = 0;
+uint64 startHooks = 0;
+
+bool pcRegistered = false;
+
+void write_hook(uint32 addr, uint8 value) {
+  writeHooks++;
+
+  if (!pcRegistered && frames >= 60) {
+    // the instruction that just wrote to WRAM is likely inside a loop:
+    cpu::register_pc_interceptor(cpu::r.pc, @pc_hook);
+    message("hook-bench: pc interceptor at 0x" + fmtHex(cpu::r.pc, 6));
+    pcRegistered = true;
+  }
+}
+
+void pc_hook(uint32 addr) {
+  pcHooks++;
+}
+
+void init() {
+  bus::add_write_interceptor("7e:0000-1fff", 0, @write_hook);
+}
+
+void pre_frame() {
+  frames++;
+
+  // warm up for two seconds before measuring:
+  if (frames == 120) {
+    startTime = chrono::nanosecond;
+    startHooks = writeHooks + pcHooks;
+    return;
+  }
+
+  // report every five seconds:
+  if (frames > 120 && (frames - 120) % 300 == 0) {
+    auto elapsed = chrono::nanosecond - startTime;
+    auto hooks = writeHooks + pcHooks - startHooks;
+    message(
+      "hook-bench: " + fmtUint(hooks * 1000000000 / elapsed) + " hooks/sec" +
+      " (write=" + fmtUint(writeHooks) + " pc=" + fmtUint(pcHooks) + ")"
+    );
+    startTime = chrono::nanosecond;
+    startHooks = writeHooks + pcHooks;
+  }
+}
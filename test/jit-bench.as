@@ -0,0 +1,116 @@
+// benchmark script to compare interpreted scripts against scripts compiled to native code.
+// load it once with "Compile Scripts to Native Code" disabled and once with it enabled (or run the headless target with
+// and without --jit) and compare the reported times. Every test only uses script code so that the emulator itself does
+// not affect the results; the checksums must be identical in both modes.
+
+int g = 0;
+int64 g64 = 0;
+float gf = 0;
+double gd = 0;
+
+int intLoop(int n) {
+  int sum = 0;
+  for (int i = 0; i < n; i++) {
+    sum += i * 3 - (i >> 1) + (i & 7) ^ (i | 2);
+    if (i % 5 == 0) sum -= 7;
+    if (i / 3 > 100) sum ^= 0x55;
+  }
+  return sum;
+}
+
+int64 int64Loop(int n) {
+  int64 a = 1;
+  uint64 u = 12345;
+  for (int i = 0; i < n; i++) {
+    a = a * 31 + i;
+    a ^= (a << 3);
+    a = a - (a >> 5);
+    u = u * 6364136223846793005 + 1442695040888963407;
+    u ^= u >> 33;
+    if (i % 3 == 0) a += int64(u % 1000);
+  }
+  return a + int64(u & 0xffff);
+}
+
+float floatLoop(int n) {
+  float x = 0.5f;
+  for (int i = 0; i < n; i++) {
+    x = x * 1.0001f + float(i) / 1000.0f;
+    x -= float(i % 7) * 0.25f;
+    if (x > 1000.0f) x = x / 3.0f;
+    if (x < -1000.0f) x = -x;
+  }
+  return x;
+}
+
+double doubleLoop(int n) {
+  double x = 0.5;
+  for (int i = 0; i < n; i++) {
+    x = x * 1.0001 + double(i) / 1000.0;
+    int k = int(x);
+    x += k % 3;
+    if (x > 1e6) x = x / 7.0;
+  }
+  return x;
+}
+
+int globalLoop(int n) {
+  for (int i = 0; i < n; i++) {
+    g++;
+    g64 += i;
+    gf += 0.5f;
+    gd += 0.25;
+  }
+  return g + int(g64 % 1000) + int(gf) + int(gd);
+}
+
+uint arrayLoop(int n) {
+  array<uint8> buffer(256);
+  uint sum = 0;
+  for (int i = 0; i < n; i++) {
+    buffer[i & 255] = uint8(i);
+    sum += buffer[(i * 7) & 255];
+  }
+  return sum;
+}
+
+int compareLoop(int n) {
+  int count = 0;
+  for (int i = 0; i < n; i++) {
+    int a = i % 17, b = i % 13;
+    if (a < b) count++;
+    if (a >= b && i % 2 == 0) count += 2;
+    if (float(a) > float(b) * 1.5f) count += 3;
+  }
+  return count;
+}
+
+funcdef int64 Test(int n);
+
+void run(const string &in name, Test @test, int n) {
+  auto start = chrono::nanosecond;
+  auto result = test(n);
+  auto elapsed = chrono::nanosecond - start;
+  message("jit-bench: " + name + " " + fmtUint(elapsed / 1000) + " us (checksum " + fmtInt(result) + ")");
+}
+
+int64 intTest(int n) { return intLoop(n); }
+int64 int64Test(int n) { return int64Loop(n); }
+int64 floatTest(int n) { return int64(floatLoop(n) * 1000.0f); }
+int64 doubleTest(int n) { return int64(doubleLoop(n) * 1000.0); }
+int64 globalTest(int n) { return globalLoop(n); }
+int64 arrayTest(int n) { return arrayLoop(n); }
+int64 compareTest(int n) { return compareLoop(n); }
+
+void init() {
+  const int n = 2000000;
+  auto start = chrono::nanosecond;
+  run("int    ", @intTest, n);
+  run("int64  ", @int64Test, n);
+  run("float  ", @floatTest, n);
+  run("double ", @doubleTest, n);
+  run("globals", @globalTest, n);
+  run("array  ", @arrayTest, n);
+  run("compare", @compareTest, n);
+  message("jit-bench: total " + fmtUint((chrono::nanosecond - start) / 1000000) + " ms");
+}
@@ -0,0 +1,27 @@
+// module loaded from the `counter` subfolder of test/modules; counts WRAM writes to the direct page.
+external shared interface Counter;
+
+class WriteCounter : Counter {
+  uint writes = 0;
+  uint count() { return writes; }
+  string name() { return "direct page writes"; }
+}
+
+WriteCounter counter;
+
+Counter@ get_counter() {
+  return counter;
+}
+
+void write_hook(uint32 addr, uint8 value) {
+  counter.writes++;
+}
+
+void init() {
+  message("counter: init");
+  bus::add_write_interceptor("7e:0000-00ff", 0, @write_hook);
+}
+
+void unload() {
+  message("counter: unload");
+}
@@ -0,0 +1,27 @@
+// AngelScript to test multi-module loading: load this folder, then edit counter/counter.as and reload. Only the
+// counter module is rebuilt; `frames` below keeps counting across the reload.
+shared interface Counter {
+  uint count();
+  string name();
+}
+
+import Counter@ get_counter() from "counter";
+
+uint frames = 0;
+
+void init() {
+  message("main: init");
+}
+
+void pre_frame() {
+  frames++;
+  if (frames % 60 != 0) return;
+
+  auto counter = get_counter();
+  if (counter is null) return;
+  message("main: frame " + fmtUint(frames) + ", " + counter.name() + " = " + fmtUint(counter.count()));
+}
+
+void unload() {
+  message("main: unload");
+}
@@ -0,0 +1,25 @@
+// retained HUD: the layer is only redrawn when the frame counter's text changes (every 60 frames), and is composited by
+// the emulator on every frame in between.
+ppu::Layer@ hud;
+uint frames = 0;
+
+void init() {
+  @hud = ppu::Layer(96, 12);
+  hud.x = 4;
+  hud.y = 4;
+  hud.alpha = 24;
+  hud.draw_op = ppu::draw_op::op_alpha;
+  redraw();
+}
+
+void redraw() {
+  hud.clear();
+  hud.color = ppu::rgb(0, 0, 8);
+  hud.fill(0, 0, hud.width, hud.height);
+  hud.color = ppu::rgb(31, 31, 31);
+  hud.text(2, 2, "sec " + fmtUint(frames / 60));
+}
+
+void post_frame() {
+  if (++frames % 60 == 0) redraw();
+}
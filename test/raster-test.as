@@ -0,0 +1,22 @@
+// splits the backdrop color at scanline 112 with ppu::on_scanline() and counts ppu::on_hv() calls.
+uint hv_calls = 0;
+
+void top(uint v) {
+  ppu::cgram[0] = ppu::rgb(0, 0, 24);
+}
+
+void bottom(uint v) {
+  ppu::cgram[0] = ppu::rgb(24, 0, 0);
+}
+
+void middle(uint h, uint v) {
+  if (++hv_calls % 600 == 0) {
+    message("on_hv(" + fmtUint(h) + ", " + fmtUint(v) + ") called " + fmtUint(hv_calls) + " times");
+  }
+}
+
+void init() {
+  ppu::on_scanline(0, @top);
+  ppu::on_scanline(112, @bottom);
+  ppu::on_hv(128, 200, @middle);
+}
@@ -0,0 +1,88 @@
+// benchmark for net::WebSocketServer.broadcast(): connects 1, 16 and 128 local net::WebSocketClients to a server and
+// reports how many messages per second reach all clients, once with broadcast() and once sending to each client in a
+// loop. The clients run in this script too, so the numbers include receiving and parsing every message.
+
+const string uri = "ws://127.0.0.1:4591/bench";
+const int rounds = 200;
+
+net::WebSocketServer@ server;
+array<net::WebSocketClient@> connecting;
+array<net::WebSocket@> clients;
+
+bool connect(int count) {
+  // close the previous server first, as both would listen on the same port:
+  @server = null;
+  @server = net::WebSocketServer(uri);
+  connecting.resize(0);
+  clients.resize(0);
+  for (int i = 0; i < count; i++) {
+    connecting.insertLast(net::WebSocketClient(uri));
+  }
+
+  auto start = chrono::millisecond;
+  while (chrono::millisecond - start < 5000) {
+    server.process();
+    clients.resize(0);
+    for (uint i = 0; i < connecting.length(); i++) {
+      auto@ ws = connecting[i].process();
+      if (ws !is null) clients.insertLast(ws);
+    }
+    if (int(clients.length()) == count && int(server.clients.length()) == count) return true;
+  }
+  message("websocket-bench: only " + fmtInt(clients.length()) + " of " + fmtInt(count) + " clients connected");
+  return false;
+}
+
+// waits until every client received the message; returns false on timeout:
+bool receive(uint size) {
+  auto start = chrono::millisecond;
+  for (uint i = 0; i < clients.length(); i++) {
+    net::WebSocketMessage@ msg = null;
+    while ((@msg = clients[i].process()) is null) {
+      if (chrono::millisecond - start > 5000) return false;
+    }
+    if (msg.as_array().length() != size) return false;
+  }
+  return true;
+}
+
+void run(int count, uint size, bool broadcast) {
+  auto@ msg = net::WebSocketMessage(2);
+  array<uint8> payload(size);
+  for (uint i = 0; i < size; i++) payload[i] = uint8(i);
+  msg.payload_as_array = payload;
+
+  auto start = chrono::nanosecond;
+  for (int r = 0; r < rounds; r++) {
+    if (broadcast) {
+      server.broadcast(msg);
+    } else {
+      auto@ targets = server.clients;
+      for (uint i = 0; i < targets.length(); i++) targets[i].send(msg);
+    }
+    if (!receive(size)) {
+      message("websocket-bench: clients did not receive every message");
+      return;
+    }
+  }
+  auto elapsed = chrono::nanosecond - start;
+
+  message("websocket-bench: " + fmtInt(count) + " clients, " + fmtUint(size) + " bytes, "
+    + (broadcast ? "broadcast: " : "send loop: ") + fmtUint(uint64(rounds) * 1000000000 / elapsed) + " messages/s, "
+    + fmtUint(uint64(rounds) * count * 1000000000 / elapsed) + " deliveries/s");
+}
+
+void init() {
+  array<int> counts = {1, 16, 128};
+  array<uint> sizes = {64, 4096, 65536};
+  for (uint c = 0; c < counts.length(); c++) {
+    if (!connect(counts[c])) return;
+    for (uint s = 0; s < sizes.length(); s++) {
+      run(counts[c], sizes[s], true);
+      run(counts[c], sizes[s], false);
+    }
+  }
+  @server = null;
+  connecting.resize(0);
+  clients.resize(0);
+}